@@ -14,9 +14,11 @@
 #include <sensor_msgs/Image.h>
 #include <cv_bridge/cv_bridge.h>
 #include <queue>
+#include <algorithm>
 #include <helper/tools.h>
 #include <helper/ObjectArray.h>
-#include <tf/transform_listener.h>
+#include <helper/FootprintArray.h>
+#include <helper/transform_cache.h>
 
 // Namespaces
 namespace detection{
@@ -40,6 +42,8 @@ struct Parameter{
 	float car_height_min;
 	float car_height_max;
 	float car_semantic_min;
+
+	bool footprint;
 };
 
 // Semantic information of a cluster
@@ -96,36 +100,48 @@ public:
 	// Default constructor
 	DbScan(ros::NodeHandle nh, ros::NodeHandle private_nh);
 
+	// Offline constructor without node handle, subscriber, publisher and tf,
+	// usable without ros::init
+	DbScan(const Parameter & params);
+
 	// Virtual destructor
 	virtual ~DbScan();
 
 	virtual void process(const Image::ConstPtr & image_detection_grid);
 
+	// Processing steps
+	void runDbScan(cv::Mat grid);
+	void getClusterDetails(const cv::Mat grid);
+	void createObjectList();
 
-private:
+	// Getter
+	const ObjectArray & getObjectArray() const;
+	const FootprintArray & getFootprintArray() const;
+	const std::vector<Cluster> & getClusters() const;
+	int getNumberOfClusters() const;
 
-	// Node handle
-	ros::NodeHandle nh_, private_nh_;
+private:
 
 	// Class member
 	std::vector<Cluster> clusters_;
 	ObjectArray object_array_;
+	FootprintArray footprint_array_;
 	int number_of_clusters_;
 	int time_frame_;
 	Parameter params_;
 	Tools tools_;
-	tf::TransformListener listener_;
+	boost::shared_ptr<TransformCache> transforms_;
+	std::vector<unsigned char> footprint_mask_;
 
-	// Subscriber
+	// Subscriber and publisher, empty handles offline since a node handle
+	// cannot be constructed before ros::init
 	ros::Subscriber image_detection_grid_sub_;
-
-	// Publisher
 	ros::Publisher object_array_pub_;
+	ros::Publisher footprint_array_pub_;
 
 	// Class functions
-	void runDbScan(cv::Mat grid);
-	void getClusterDetails(const cv::Mat grid);
-	void createObjectList();
+	void encodeFootprint(const std::vector<cv::Point> & cells,
+		Footprint & f);
 	void addObject(const Cluster & c);
 	bool hasShapeOfPed(const Cluster & c);
 	bool hasShapeOfCar(const Cluster & c);
@@ -0,0 +1,320 @@
+/******************************************************************************
+ *
+ * Scalability benchmark of the DbScan detection on synthetic detection grids.
+ * Usage: rosrun detection detection_benchmark [--cars N] [--peds N]
+ *        [--noise N] [--free F] [--runs N] [--cells 0.25,0.2,0.15,0.1]
+ *        [--far_range R] [--far_gap G]
+ *
+ */
+
+#include <detection_lib/dbscan.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+using namespace detection;
+
+// Semantic classes and grid encoding as written by the sensor processing
+static const int PEDESTRIAN = 11;
+static const int CAR = 13;
+static const float FREE_SPACE = -50.0;
+static const float UNKNOWN = -100.0;
+static const float GROUND = -1.73;
+
+struct BenchmarkConfig{
+
+	int cars;
+	int peds;
+	int noise;
+	float free;
+	int runs;
+	float range;
+	std::vector<float> cell_sizes;
+	float far_range;
+	float far_gap;
+};
+
+// Rasterized car or pedestrian in grid cells
+struct Blob{
+
+	int semantic;
+	int y;
+	int x;
+	float yaw;
+	float half_w;
+	float half_l;
+	float range;
+};
+
+static std::string getArg(int argc, char ** argv, const std::string & name,
+	const std::string & default_value){
+
+	for(int i = 1; i < argc - 1; ++i){
+		if(name == argv[i])
+			return argv[i + 1];
+	}
+	return default_value;
+}
+
+static std::vector<float> parseList(const std::string & list){
+
+	std::vector<float> values;
+	std::stringstream stream(list);
+	std::string item;
+	while(std::getline(stream, item, ',')){
+		values.push_back(std::atof(item.c_str()));
+	}
+	return values;
+}
+
+// Same parameters as detection/config/parameters.yaml
+static Parameter getParameter(const BenchmarkConfig & config,
+	const float cell_size){
+
+	Parameter params;
+	params.grid_range_max = config.range;
+	params.grid_cell_size = cell_size;
+	params.ped_side_min = 0.55;
+	params.ped_side_max = 2.10;
+	params.ped_height_min = 1.10;
+	params.ped_height_max = 2.25;
+	params.ped_semantic_min = 0.80;
+	params.car_side_min = 1.30;
+	params.car_side_max = 6.00;
+	params.car_height_min = 1.10;
+	params.car_height_max = 2.00;
+	params.car_semantic_min = 0.60;
+	params.footprint = true;
+	return params;
+}
+
+// Cells scanned by DbScan::runDbScan, away from the grid border
+static bool isInsideScanArea(const cv::Mat & grid, const int y, const int x,
+	const int margin){
+
+	return y >= margin && y < grid.rows - margin &&
+		x >= y + margin && x < grid.cols - y - margin;
+}
+
+// Whether a cell lies inside a blob, with a tolerance in cells
+static bool isInsideBlob(const Blob & b, const int y, const int x,
+	const float tolerance){
+
+	float u = std::cos(b.yaw) * (x - b.x) + std::sin(b.yaw) * (y - b.y);
+	float v = -std::sin(b.yaw) * (x - b.x) + std::cos(b.yaw) * (y - b.y);
+	return std::fabs(u) <= b.half_l + tolerance &&
+		std::fabs(v) <= b.half_w + tolerance;
+}
+
+static void addBlob(cv::Mat & grid, cv::RNG & rng,
+	const BenchmarkConfig & config, const int semantic, const float width,
+	const float length, const float height, const float cell_size,
+	std::vector<Blob> & blobs){
+
+	// Draw center and orientation of the blob
+	int margin = 4 + int(std::ceil(length / cell_size));
+	int y = rng.uniform(margin, grid.rows / 2);
+	int x = rng.uniform(y + margin, std::max(y + margin + 1,
+		grid.cols - y - margin));
+	if(!isInsideScanArea(grid, y, x, margin))
+		return;
+	Blob b;
+	b.semantic = semantic;
+	b.y = y;
+	b.x = x;
+	b.yaw = rng.uniform(0.f, float(M_PI));
+	b.half_w = width / cell_size / 2;
+	b.half_l = length / cell_size / 2;
+	b.range = std::sqrt(std::pow(config.range - y * cell_size, 2) +
+		std::pow(config.range - x * cell_size, 2));
+	int extent = int(std::ceil(b.half_l)) + 1;
+
+	// Far objects are only hit on scan lines, which are further apart with
+	// range, the cells in between stay unknown
+	int line_step = 1;
+	if(config.far_gap > 0 && b.range > config.far_range)
+		line_step = std::max(1, int(config.far_gap * b.range /
+			config.far_range / cell_size + 0.5));
+
+	// Rasterize rotated rectangle with a ring of free space around it
+	for(int k = -extent - 2; k <= extent + 2; ++k){
+		for(int l = -extent - 2; l <= extent + 2; ++l){
+			cv::Vec3f & cell = grid.at<cv::Vec3f>(y + k, x + l);
+			if(isInsideBlob(b, y + k, x + l, 0.f)){
+				if((y + k) % line_step == 0){
+					cell[0] = semantic;
+					cell[1] = GROUND;
+					cell[2] = GROUND + height;
+				}
+				else{
+					cell[0] = UNKNOWN;
+				}
+			}
+			else if(cell[0] < 0){
+				cell[0] = FREE_SPACE;
+			}
+		}
+	}
+	blobs.push_back(b);
+}
+
+// Far cars split into several car clusters and far cars found as exactly
+// one object
+static void countFragments(const DbScan & detector,
+	const std::vector<Blob> & blobs, const float far_range,
+	int & far_cars, int & split, int & found){
+
+	far_cars = 0;
+	split = 0;
+	found = 0;
+	const std::vector<Cluster> & clusters = detector.getClusters();
+	for(int i = 0; i < blobs.size(); ++i){
+
+		const Blob & b = blobs[i];
+		if(b.semantic != CAR || b.range <= far_range)
+			continue;
+		far_cars++;
+
+		// Car clusters with their first cell on the blob
+		int fragments = 0;
+		int objects = 0;
+		for(int j = 0; j < clusters.size(); ++j){
+			const Cluster & c = clusters[j];
+			if(c.semantic.id != CAR || c.geometric.cells.empty() ||
+				!isInsideBlob(b, c.geometric.cells[0].y,
+				c.geometric.cells[0].x, 1.f))
+				continue;
+			fragments++;
+			if(c.is_track)
+				objects++;
+		}
+		if(fragments > 1)
+			split++;
+		if(fragments == 1 && objects == 1)
+			found++;
+	}
+}
+
+static cv::Mat createGrid(const BenchmarkConfig & config,
+	const float cell_size, std::vector<Blob> & blobs){
+
+	int rows = config.range / cell_size;
+	int cols = rows * 2;
+	cv::Mat grid(rows, cols, CV_32FC3, cv::Scalar(UNKNOWN, 0.0, 0.0));
+	cv::RNG rng(2345);
+
+	// Free space
+	for(int y = 0; y < rows; ++y){
+		for(int x = 0; x < cols; ++x){
+			if(rng.uniform(0.f, 1.f) < config.free)
+				grid.at<cv::Vec3f>(y, x)[0] = FREE_SPACE;
+		}
+	}
+
+	// Objects
+	for(int i = 0; i < config.cars; ++i)
+		addBlob(grid, rng, config, CAR, 1.8, 4.2, 1.5, cell_size, blobs);
+	for(int i = 0; i < config.peds; ++i)
+		addBlob(grid, rng, config, PEDESTRIAN, 0.6, 0.8, 1.7, cell_size,
+			blobs);
+
+	// Noise cells with random semantic
+	for(int i = 0; i < config.noise; ++i){
+		int y = rng.uniform(4, rows - 4);
+		int x = rng.uniform(4, cols - 4);
+		cv::Vec3f & cell = grid.at<cv::Vec3f>(y, x);
+		if(cell[0] < 0){
+			cell[0] = rng.uniform(0, 19);
+			cell[1] = GROUND;
+			cell[2] = GROUND + rng.uniform(0.1f, 2.0f);
+		}
+	}
+
+	return grid;
+}
+
+static double elapsed(const std::chrono::steady_clock::time_point & start,
+	const std::chrono::steady_clock::time_point & end){
+
+	return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char **argv){
+
+	// Read configuration
+	BenchmarkConfig config;
+	config.cars = std::atoi(getArg(argc, argv, "--cars", "20").c_str());
+	config.peds = std::atoi(getArg(argc, argv, "--peds", "40").c_str());
+	config.noise = std::atoi(getArg(argc, argv, "--noise", "2000").c_str());
+	config.free = std::atof(getArg(argc, argv, "--free", "0.5").c_str());
+	config.runs = std::atoi(getArg(argc, argv, "--runs", "20").c_str());
+	config.range = std::atof(getArg(argc, argv, "--range", "83.0").c_str());
+	config.cell_sizes = parseList(
+		getArg(argc, argv, "--cells", "0.25,0.2,0.15,0.1"));
+	config.far_range = std::atof(
+		getArg(argc, argv, "--far_range", "40.0").c_str());
+	config.far_gap = std::atof(getArg(argc, argv, "--far_gap", "0").c_str());
+
+	std::printf("Detection benchmark: %d cars, %d pedestrians, %d noise cells,"
+		" %.2f free space, %d runs, far range from %.1f m with scan line gap"
+		" %.2f m\n", config.cars, config.peds, config.noise, config.free,
+		config.runs, config.far_range, config.far_gap);
+	std::printf("%6s %11s %10s %8s %7s %10s %10s %10s %12s %12s %8s %6s"
+		" %6s\n", "cell", "grid", "cells", "clusters", "objects",
+		"dbscan[ms]", "details[ms]", "objects[ms]", "cells/s", "clusters/s",
+		"far_cars", "split", "found");
+
+	for(int r = 0; r < config.cell_sizes.size(); ++r){
+
+		// Create detector and synthetic grid for this resolution
+		float cell_size = config.cell_sizes[r];
+		DbScan detector(getParameter(config, cell_size));
+		std::vector<Blob> blobs;
+		cv::Mat grid = createGrid(config, cell_size, blobs);
+
+		double t_dbscan = 0.0;
+		double t_details = 0.0;
+		double t_objects = 0.0;
+		for(int i = 0; i < config.runs; ++i){
+
+			// Clustering marks visited cells, so work on a copy
+			cv::Mat work = grid.clone();
+
+			std::chrono::steady_clock::time_point t0 =
+				std::chrono::steady_clock::now();
+			detector.runDbScan(work);
+			std::chrono::steady_clock::time_point t1 =
+				std::chrono::steady_clock::now();
+			detector.getClusterDetails(grid);
+			std::chrono::steady_clock::time_point t2 =
+				std::chrono::steady_clock::now();
+			detector.createObjectList();
+			std::chrono::steady_clock::time_point t3 =
+				std::chrono::steady_clock::now();
+
+			t_dbscan += elapsed(t0, t1);
+			t_details += elapsed(t1, t2);
+			t_objects += elapsed(t2, t3);
+		}
+
+		// Report mean timings and throughput
+		double cells = double(grid.rows) * grid.cols;
+		int clusters = detector.getNumberOfClusters();
+		int objects = detector.getObjectArray().list.size();
+		int far_cars, split, found;
+		countFragments(detector, blobs, config.far_range, far_cars,
+			split, found);
+		std::ostringstream size;
+		size << grid.cols << "x" << grid.rows;
+		std::printf("%6.3f %11s %10.0f %8d %7d %10.3f %10.3f %10.3f %12.4g"
+			" %12.4g %8d %6d %6d\n", cell_size, size.str().c_str(), cells,
+			clusters, objects, 1e3 * t_dbscan / config.runs,
+			1e3 * t_details / config.runs, 1e3 * t_objects / config.runs,
+			cells * config.runs / t_dbscan,
+			clusters * config.runs / (t_dbscan + t_details + t_objects),
+			far_cars, split, found);
+	}
+
+	return 0;
+}
@@ -11,36 +11,34 @@ namespace detection{
 
 /******************************************************************************/
 
-DbScan::DbScan(ros::NodeHandle nh, ros::NodeHandle private_nh):
-	nh_(nh),
-	private_nh_(private_nh)
-	{
+DbScan::DbScan(ros::NodeHandle nh, ros::NodeHandle private_nh){
 
 	// Get parameter
-	private_nh_.param("grid/range/max", params_.grid_range_max,
+	private_nh.param("grid/range/max", params_.grid_range_max,
 		params_.grid_range_max);
-	private_nh_.param("grid/cell/size", params_.grid_cell_size,
+	private_nh.param("grid/cell/size", params_.grid_cell_size,
 		params_.grid_cell_size);
-	private_nh_.param("pedestrian/side/min", params_.ped_side_min,
+	private_nh.param("pedestrian/side/min", params_.ped_side_min,
 		params_.ped_side_min);
-	private_nh_.param("pedestrian/side/max", params_.ped_side_max,
+	private_nh.param("pedestrian/side/max", params_.ped_side_max,
 		params_.ped_side_max);
-	private_nh_.param("pedestrian/height/min", params_.ped_height_min,
+	private_nh.param("pedestrian/height/min", params_.ped_height_min,
 		params_.ped_height_min);
-	private_nh_.param("pedestrian/height/max", params_.ped_height_max,
+	private_nh.param("pedestrian/height/max", params_.ped_height_max,
 		params_.ped_height_max);
-	private_nh_.param("pedestrian/semantic/min", params_.ped_semantic_min,
+	private_nh.param("pedestrian/semantic/min", params_.ped_semantic_min,
 		params_.ped_semantic_min);
-	private_nh_.param("car/side/min", params_.car_side_min,
+	private_nh.param("car/side/min", params_.car_side_min,
 		params_.car_side_min);
-	private_nh_.param("car/side/max", params_.car_side_max,
+	private_nh.param("car/side/max", params_.car_side_max,
 		params_.car_side_max);
-	private_nh_.param("car/height/min", params_.car_height_min,
+	private_nh.param("car/height/min", params_.car_height_min,
 		params_.car_height_min);
-	private_nh_.param("car/height/max", params_.car_height_max,
+	private_nh.param("car/height/max", params_.car_height_max,
 		params_.car_height_max);
-	private_nh_.param("car/semantic/min", params_.car_semantic_min,
+	private_nh.param("car/semantic/min", params_.car_semantic_min,
 		params_.car_semantic_min);
+	private_nh.param("footprint/publish", params_.footprint, false);
 
 	// Print parameters
 	ROS_INFO_STREAM("ped_side_min " << params_.ped_side_min);
@@ -53,23 +51,59 @@ DbScan::DbScan(ros::NodeHandle nh, ros::NodeHandle private_nh):
 	ROS_INFO_STREAM("car_height_min " << params_.car_height_min);
 	ROS_INFO_STREAM("car_height_max " << params_.car_height_max);
 	ROS_INFO_STREAM("car_semantic_min " << params_.car_semantic_min);
+	ROS_INFO_STREAM("footprint " << params_.footprint);
 
 	// Init counter for publishing
 	time_frame_ = 0;
 
+	// Init transform lookups on the tf buffer shared by all nodelets
+	transforms_.reset(new TransformCache);
+
 	// Define Subscriber
 	image_detection_grid_sub_ = nh.subscribe(
 		"/sensor/image/detection_grid", 2, &DbScan::process, this);
 
 	// Define Publisher
-	object_array_pub_ = nh_.advertise<ObjectArray>(
+	object_array_pub_ = nh.advertise<ObjectArray>(
 		"/detection/objects", 2);
+	if(params_.footprint)
+		footprint_array_pub_ = nh.advertise<FootprintArray>(
+			"/detection/footprints", 2);
+}
+
+DbScan::DbScan(const Parameter & params):
+	params_(params)
+	{
+
+	// Init counter
+	time_frame_ = 0;
+	number_of_clusters_ = 0;
 }
 
 DbScan::~DbScan(){
 
 }
 
+const ObjectArray & DbScan::getObjectArray() const{
+
+	return object_array_;
+}
+
+const FootprintArray & DbScan::getFootprintArray() const{
+
+	return footprint_array_;
+}
+
+const std::vector<Cluster> & DbScan::getClusters() const{
+
+	return clusters_;
+}
+
+int DbScan::getNumberOfClusters() const{
+
+	return number_of_clusters_;
+}
+
 void DbScan::process(const Image::ConstPtr & image_detection_grid){
 
 	// Convert image detection grid to cv mat detection grid
@@ -95,6 +129,12 @@ void DbScan::process(const Image::ConstPtr & image_detection_grid){
 	object_array_.header = image_detection_grid->header;
 	object_array_pub_.publish(object_array_);
 
+	// Publish footprints of the objects with the same header
+	if(params_.footprint){
+		footprint_array_.header = image_detection_grid->header;
+		footprint_array_pub_.publish(footprint_array_);
+	}
+
 	// Print cluster info
 	for(int i = 0; i < number_of_clusters_; ++i){
 		if(clusters_[i].is_track)
@@ -141,8 +181,6 @@ void DbScan::runDbScan(cv::Mat grid){
 			if(!fs_next_to_cell)
 				continue;
 
-			std::cout << y << " " << x << " " << semantic_class << std::endl;
-				
 			// Flag cell as visited
 			grid.at<cv::Vec3f>(y,x)[0] = -100.0;
 
@@ -234,6 +272,48 @@ void DbScan::runDbScan(cv::Mat grid){
 	number_of_clusters_ = clusters_.size();
 }
 
+void DbScan::encodeFootprint(const std::vector<cv::Point> & cells,
+	Footprint & f){
+
+	f.row.clear();
+	f.col_begin.clear();
+	f.col_end.clear();
+	if(cells.empty())
+		return;
+
+	// Bounding box of the cells
+	int x_min = cells[0].x, x_max = cells[0].x;
+	int y_min = cells[0].y, y_max = cells[0].y;
+	for(int i = 1; i < cells.size(); ++i){
+		x_min = std::min(x_min, cells[i].x);
+		x_max = std::max(x_max, cells[i].x);
+		y_min = std::min(y_min, cells[i].y);
+		y_max = std::max(y_max, cells[i].y);
+	}
+
+	// Mark the cells in a mask of the box, so the runs come out of one scan
+	// of its rows without sorting the cells
+	int width = x_max - x_min + 1;
+	footprint_mask_.assign(width * (y_max - y_min + 1), 0);
+	for(int i = 0; i < cells.size(); ++i)
+		footprint_mask_[(cells[i].y - y_min) * width + cells[i].x - x_min] = 1;
+
+	// Merge neighboring cells of a row into runs
+	for(int y = y_min; y <= y_max; ++y){
+		const unsigned char * row = &footprint_mask_[(y - y_min) * width];
+		for(int x = 0; x < width; ++x){
+			if(!row[x])
+				continue;
+			int begin = x;
+			while(x < width && row[x])
+				x++;
+			f.row.push_back(y);
+			f.col_begin.push_back(x_min + begin);
+			f.col_end.push_back(x_min + x);
+		}
+	}
+}
+
 void DbScan::getClusterDetails(const cv::Mat grid){
 
 	// Loop through clusters
@@ -310,6 +390,7 @@ void DbScan::createObjectList(){
 
 	// Clear buffer
 	object_array_.list.clear();
+	footprint_array_.list.clear();
 
 	// Loop through clusters to obtain object information
 	for(int i = 0; i < number_of_clusters_; ++i){
@@ -317,18 +398,16 @@ void DbScan::createObjectList(){
 			addObject(clusters_[i]);
 	}
 
-	// Transform objects in camera and world frame
-	try{
-		for(int i = 0; i < object_array_.list.size(); ++i){
-
-			listener_.transformPoint("world",
-				object_array_.list[i].velo_pose,
-				object_array_.list[i].world_pose);
+	// Offline usage has no transform tree
+	if(!transforms_)
+		return;
 
-			listener_.transformPoint("camera_color_left",
-				object_array_.list[i].velo_pose,
-				object_array_.list[i].cam_pose);
-		}
+	// Transform objects in camera and world frame, one lookup per frame
+	try{
+		transforms_->transformObjects(object_array_, &Object::velo_pose,
+			"world", &Object::world_pose);
+		transforms_->transformObjects(object_array_, &Object::velo_pose,
+			"camera_color_left", &Object::cam_pose);
 	}
 	catch(tf::TransformException& ex){
 		ROS_ERROR("Received an exception trying to transform a point from"
@@ -354,6 +433,13 @@ void DbScan::addObject(const Cluster & c){
 	object.height = c.geometric.height;
 	object.orientation = c.geometric.orientation;
 
+	// Run length encoded cells, only for the clusters which become objects
+	if(params_.footprint){
+		footprint_array_.list.push_back(Footprint());
+		footprint_array_.list.back().id = object.id;
+		encodeFootprint(c.geometric.cells, footprint_array_.list.back());
+	}
+
 	// Semantic
 	object.semantic_id = c.semantic.id;
 	object.semantic_confidence = c.semantic.confidence;
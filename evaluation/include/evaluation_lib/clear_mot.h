@@ -0,0 +1,140 @@
+// Include guard
+#ifndef clear_mot_H
+#define clear_mot_H
+
+// Includes
+#include <evaluation_lib/kitti_labels.h>
+#include <helper/kitti_record.h>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Namespaces
+namespace evaluation{
+
+// CLEAR MOT and identity metrics of one class
+struct MotMetrics{
+
+	// Counts over all frames
+	int frames;
+	int ground_truth;
+	int true_positives;
+	int false_positives;
+	int misses;
+	int id_switches;
+	int fragmentations;
+	double iou_sum;
+
+	// Ground truth trajectories tracked at least 80%, between 20% and 80%
+	// and less than 20% of their frames
+	int trajectories;
+	int mostly_tracked;
+	int partly_tracked;
+	int mostly_lost;
+
+	// Identity true positives, false positives and misses
+	int id_true_positives;
+	int id_false_positives;
+	int id_misses;
+
+	double mota;
+	double motp;
+	double precision;
+	double recall;
+	double idf1;
+	double idp;
+	double idr;
+};
+
+/*
+ * CLEAR MOT metrics of one class on the image boxes of the KITTI tracking
+ * benchmark. Every frame the tracks are matched to the ground truth by an
+ * optimal assignment on 2D box IoU. As in the KITTI devkit, ground truth of
+ * the neighbouring class (Van, Person_sitting), truncated, heavily occluded
+ * or smaller than 25 pixels is ignored, and so are tracks matched to it, of
+ * the same size limit or inside DontCare regions. Counts accumulate frame by
+ * frame, so the metrics can be read at any time.
+ */
+class ClearMot{
+
+public:
+
+	// Default constructor
+	ClearMot();
+
+	// Virtual destructor
+	virtual ~ClearMot();
+
+	// Evaluate a class, "Car" or "Pedestrian", against the labels, which
+	// have to outlive the evaluation
+	void init(const KittiLabels * labels, const std::string & class_name,
+		const double min_iou = 0.5);
+
+	// Remove all accumulated counts
+	void reset();
+
+	// Match the tracks of a frame, tracks of other classes are skipped
+	void addFrame(const int frame, const KittiRecord * tracks,
+		const int count);
+
+	// Metrics of all frames so far, identity metrics solve one assignment
+	// of all trajectories
+	MotMetrics getMetrics() const;
+
+	// CLEAR MOT counts and scores of all frames so far without trajectory
+	// and identity metrics, constant cost for reports every frame
+	MotMetrics getCounts() const;
+
+private:
+
+	// Ground truth and evaluated class
+	const KittiLabels * labels_;
+	std::string class_name_;
+	int type_;
+	int neighbour_type_;
+	double min_iou_;
+
+	// Accumulated counts
+	MotMetrics counts_;
+	int hypotheses_;
+
+	// State of a ground truth trajectory
+	struct Trajectory{
+
+		int last_track;
+		bool tracked_before;
+		bool tracked_last;
+		int frames;
+		int tracked;
+	};
+	std::map<int, Trajectory> trajectories_;
+
+	// Frames in which a ground truth trajectory and a track overlap
+	std::map<std::pair<int, int>, int> overlaps_;
+
+	// Buffers of the frame
+	std::vector<const KittiLabel *> frame_labels_;
+	std::vector<const KittiLabel *> dont_care_;
+	std::vector<const KittiRecord *> frame_tracks_;
+};
+
+// Intersection over union of two image boxes
+double getIoU(const float a_left, const float a_top, const float a_right,
+	const float a_bottom, const float b_left, const float b_top,
+	const float b_right, const float b_bottom);
+
+// Scores of the counts
+void computeScores(MotMetrics & metrics);
+
+// Add the counts of another sequence and update the scores
+void addMetrics(MotMetrics & sum, const MotMetrics & metrics);
+
+// One line with the main metrics
+void printMetrics(std::ostream & stream, const std::string & name,
+	const MotMetrics & metrics);
+
+} // namespace evaluation
+
+#endif // clear_mot_H
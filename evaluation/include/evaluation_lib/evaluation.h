@@ -14,7 +14,10 @@
 #include <sensor_msgs/Image.h>
 #include <cv_bridge/cv_bridge.h>
 #include <opencv2/opencv.hpp>
-#include <tf/transform_listener.h>
+#include <helper/transform_cache.h>
+#include <evaluation_lib/result_writer.h>
+#include <evaluation_lib/result_file.h>
+#include <evaluation_lib/clear_mot.h>
 #include <helper/ObjectArray.h>
 #include <helper/tools.h>
 
@@ -44,15 +47,26 @@ private:
 	ros::NodeHandle nh_, private_nh_;
 
 	// Class member
-	std::ofstream tracking_results_;
+	ResultWriter tracking_results_;
+	ResultWriter binary_results_;
 	std::string filename_;
 	int time_frame_;
-	tf::TransformListener listener_;
+	TransformCache transforms_;
+	std::vector<KittiRecord> records_;
+
+	// Metrics
+	bool metrics_;
+	KittiLabels labels_;
+	ClearMot car_metrics_;
+	ClearMot ped_metrics_;
 	Tools tools_;
 
 	// Subscriber
 	ros::Subscriber list_tracked_objects_sub_;
 
+	// Parameters below a namespace as text for the binary results
+	std::string getParameterText(const std::string & prefix);
+
 };
 
 } // namespace evaluation
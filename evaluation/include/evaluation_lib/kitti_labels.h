@@ -0,0 +1,122 @@
+// Include guard
+#ifndef kitti_labels_H
+#define kitti_labels_H
+
+// Includes
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Namespaces
+namespace evaluation{
+
+// Object types of the KITTI tracking labels
+enum LabelType{
+
+	LABEL_CAR,
+	LABEL_VAN,
+	LABEL_PEDESTRIAN,
+	LABEL_PERSON_SITTING,
+	LABEL_DONTCARE,
+	LABEL_OTHER
+};
+
+// Ground truth object of one frame
+struct KittiLabel{
+
+	int frame;
+	int id;
+	int type;
+	int truncated;
+	int occluded;
+	float left;
+	float top;
+	float right;
+	float bottom;
+};
+
+// Version of the label cache files
+static const uint32_t KITTI_LABEL_CACHE_MAGIC = 0x4c42544b; // "KTBL"
+static const uint32_t KITTI_LABEL_CACHE_VERSION = 1;
+
+// Header of a label cache file, followed by the first label of each frame
+// and the end (int32_t[frames + 1]), padded to 8 bytes, and the labels
+struct KittiLabelCacheHeader{
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t label_size;
+	uint32_t frames;
+	uint32_t count;
+	uint32_t reserved;
+
+	// Label file the cache was built from
+	int64_t source_size;
+	int64_t source_mtime_sec;
+	int64_t source_mtime_nsec;
+};
+
+static_assert(sizeof(KittiLabel) == 36, "KittiLabel layout changed");
+static_assert(sizeof(KittiLabelCacheHeader) == 48,
+	"KittiLabelCacheHeader layout changed");
+
+/*
+ * Ground truth of one KITTI tracking sequence. All labels are stored ordered
+ * by frame with the offset of each frame, so the labels of a frame are one
+ * contiguous range. A label file is parsed once into <file>.cache next to it,
+ * later loads map the cache read only as long as size and modification time
+ * of the label file match, and serve the frames in place.
+ */
+class KittiLabels{
+
+public:
+
+	// Default constructor
+	KittiLabels();
+
+	// Virtual destructor, unmaps the cache
+	virtual ~KittiLabels();
+
+	// Read a label file of the tracking benchmark through its cache, false if
+	// it cannot be read. Without a writable cache the labels are parsed into
+	// memory.
+	bool load(const std::string & filename, const bool cache = true);
+	void close();
+
+	// Type of a label name
+	static int getType(const std::string & name);
+
+	// Getter
+	int getNumberOfFrames() const;
+	int size() const;
+	bool isMapped() const;
+	const KittiLabel * getFrame(const int frame, int & count) const;
+
+private:
+
+	// Labels ordered by frame and the first label of each frame, either in
+	// the mapped cache or parsed
+	const KittiLabel * labels_;
+	const int32_t * frame_begin_;
+	int frames_;
+	int count_;
+
+	// Mapped cache
+	const char * data_;
+	size_t size_;
+
+	// Parsed labels
+	std::vector<KittiLabel> parsed_labels_;
+	std::vector<int32_t> parsed_frame_begin_;
+
+	bool parse(const std::string & filename);
+	void index();
+	bool map(const std::string & filename, const KittiLabelCacheHeader & key);
+	bool write(const std::string & filename,
+		const KittiLabelCacheHeader & key) const;
+};
+
+} // namespace evaluation
+
+#endif // kitti_labels_H
@@ -0,0 +1,59 @@
+// Include guard
+#ifndef result_file_H
+#define result_file_H
+
+// Includes
+#include <helper/kitti_record.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Namespaces
+namespace evaluation{
+
+/*
+ * Binary tracking results of helper/kitti_record.h, memory mapped read only.
+ * Opening indexes the frame blocks once, afterwards the records of a frame
+ * are read in place without parsing or copying.
+ */
+class ResultFile{
+
+public:
+
+	// Default constructor
+	ResultFile();
+
+	// Virtual destructor, unmaps the file
+	virtual ~ResultFile();
+
+	// Map a file and index its complete frames, false if it is no result
+	// file of this version
+	bool open(const std::string & filename);
+	void close();
+
+	// File header with scenario and parameter text, padded for the records
+	static std::string createHeader(const std::string & scenario,
+		const std::string & parameters);
+
+	// Getter
+	std::string getScenario() const;
+	std::string getParameters() const;
+	int getNumberOfFrames() const;
+	int getFrame(const int k) const;
+	const KittiRecord * getRecords(const int k, int & count) const;
+
+private:
+
+	// Mapped file
+	const char * data_;
+	size_t size_;
+
+	// Offset of each frame block
+	std::vector<size_t> blocks_;
+
+	bool index();
+};
+
+} // namespace evaluation
+
+#endif // result_file_H
@@ -0,0 +1,80 @@
+// Include guard
+#ifndef result_writer_H
+#define result_writer_H
+
+// Includes
+#include <evaluation_lib/spsc_queue.h>
+#include <helper/tools.h>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Namespaces
+namespace evaluation{
+
+// Preformatted result line or binary record
+struct ResultRecord{
+
+	int size;
+	char data[Tools::KITTI_LINE_SIZE];
+};
+
+/*
+ * Writes result lines to one file on a background thread. The callback
+ * formats each line or binary record into a slot of a lock free queue, the
+ * writer thread collects them into one buffer and writes it once it holds
+ * flush_size bytes or flush_interval seconds passed, and on stop.
+ */
+class ResultWriter{
+
+public:
+
+	// Default constructor
+	ResultWriter();
+
+	// Virtual destructor, writes all queued lines
+	virtual ~ResultWriter();
+
+	// Truncate the file, write the header and start the writer thread, false
+	// if the file cannot be opened
+	bool start(const std::string & filename, const int flush_size,
+		const double flush_interval, const int queue_size,
+		const std::string & header = std::string());
+
+	// Write all queued lines, close the file and join the writer thread
+	void stop();
+
+	// Slot for the next line, only waits while the queue is full
+	ResultRecord & next();
+
+	// Hand over the line written into the slot of next
+	void commit();
+
+	// Getter
+	bool isRunning() const;
+	int getStalls() const;
+
+private:
+
+	// Output file
+	std::ofstream file_;
+	size_t flush_size_;
+	double flush_interval_;
+
+	// Writer thread
+	std::thread thread_;
+	std::unique_ptr<SpscQueue<ResultRecord> > queue_;
+	std::atomic<bool> stop_;
+	bool running_;
+
+	// Number of times the callback waited for a full queue
+	int stalls_;
+
+	void run();
+};
+
+} // namespace evaluation
+
+#endif // result_writer_H
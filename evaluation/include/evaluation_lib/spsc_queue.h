@@ -0,0 +1,77 @@
+// Include guard
+#ifndef spsc_queue_H
+#define spsc_queue_H
+
+// Includes
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Namespaces
+namespace evaluation{
+
+/*
+ * Bounded lock free queue for exactly one producer and one consumer thread.
+ * Elements live in a ring of preallocated slots, so pushing and popping never
+ * allocate. Head and tail are on separate cache lines to avoid false sharing.
+ */
+template<typename T>
+class SpscQueue{
+
+public:
+
+	// Queue of at least capacity elements, rounded up to a power of two
+	explicit SpscQueue(const size_t capacity):
+		head_(0),
+		tail_(0){
+		size_t n = 2;
+		while(n < capacity)
+			n *= 2;
+		slots_.resize(n);
+		mask_ = n - 1;
+	}
+
+	// Producer: slot to fill, NULL if the queue is full
+	T * front(){
+		size_t tail = tail_.load(std::memory_order_relaxed);
+		if(tail - head_.load(std::memory_order_acquire) > mask_)
+			return NULL;
+		return &slots_[tail & mask_];
+	}
+
+	// Producer: publish the slot returned by front
+	void push(){
+		tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+			std::memory_order_release);
+	}
+
+	// Consumer: oldest element, NULL if the queue is empty
+	T * peek(){
+		size_t head = head_.load(std::memory_order_relaxed);
+		if(head == tail_.load(std::memory_order_acquire))
+			return NULL;
+		return &slots_[head & mask_];
+	}
+
+	// Consumer: release the element returned by peek
+	void pop(){
+		head_.store(head_.load(std::memory_order_relaxed) + 1,
+			std::memory_order_release);
+	}
+
+	// Getter
+	size_t capacity() const{
+		return mask_ + 1;
+	}
+
+private:
+
+	std::vector<T> slots_;
+	size_t mask_;
+	alignas(64) std::atomic<size_t> head_;
+	alignas(64) std::atomic<size_t> tail_;
+};
+
+} // namespace evaluation
+
+#endif // spsc_queue_H
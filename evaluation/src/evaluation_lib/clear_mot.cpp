@@ -0,0 +1,334 @@
+#include <evaluation_lib/clear_mot.h>
+#include <helper/assignment.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace evaluation{
+
+// Cost of a pair below the minimum IoU, larger than any sum of valid costs
+static const double INVALID_COST = 1e9;
+
+// Smallest evaluated box height in pixels
+static const float MIN_HEIGHT = 25.0;
+
+// Share of a track box inside a DontCare region to ignore the track
+static const double DONT_CARE_OVERLAP = 0.5;
+
+// Highest evaluated truncation and occlusion level of the ground truth
+static const int MAX_TRUNCATION = 0;
+static const int MAX_OCCLUSION = 2;
+
+static double ratio(const double a, const double b){
+
+	return (b > 0.0) ? a / b : 0.0;
+}
+
+static double getArea(const float left, const float top, const float right,
+	const float bottom){
+
+	return std::max(0.0f, right - left) * std::max(0.0f, bottom - top);
+}
+
+static double getIntersection(const float a_left, const float a_top,
+	const float a_right, const float a_bottom, const float b_left,
+	const float b_top, const float b_right, const float b_bottom){
+
+	return getArea(std::max(a_left, b_left), std::max(a_top, b_top),
+		std::min(a_right, b_right), std::min(a_bottom, b_bottom));
+}
+
+double getIoU(const float a_left, const float a_top, const float a_right,
+	const float a_bottom, const float b_left, const float b_top,
+	const float b_right, const float b_bottom){
+
+	double intersection = getIntersection(a_left, a_top, a_right, a_bottom,
+		b_left, b_top, b_right, b_bottom);
+	double area = getArea(a_left, a_top, a_right, a_bottom) +
+		getArea(b_left, b_top, b_right, b_bottom) - intersection;
+	return ratio(intersection, area);
+}
+
+void printMetrics(std::ostream & stream, const std::string & name,
+	const MotMetrics & metrics){
+
+	char line[512];
+	std::snprintf(line, sizeof(line), "%-10s MOTA %6.3f MOTP %6.3f IDF1 %6.3f"
+		" Prec %6.3f Rec %6.3f TP %6d FP %6d FN %6d IDS %5d FRAG %5d"
+		" MT %4d PT %4d ML %4d", name.c_str(), metrics.mota, metrics.motp,
+		metrics.idf1, metrics.precision, metrics.recall,
+		metrics.true_positives, metrics.false_positives, metrics.misses,
+		metrics.id_switches, metrics.fragmentations, metrics.mostly_tracked,
+		metrics.partly_tracked, metrics.mostly_lost);
+	stream << line;
+}
+
+void computeScores(MotMetrics & metrics){
+
+	metrics.mota = 1.0 - ratio(metrics.misses + metrics.false_positives +
+		metrics.id_switches, metrics.ground_truth);
+	metrics.motp = ratio(metrics.iou_sum, metrics.true_positives);
+	metrics.precision = ratio(metrics.true_positives,
+		metrics.true_positives + metrics.false_positives);
+	metrics.recall = ratio(metrics.true_positives, metrics.ground_truth);
+	metrics.idp = ratio(metrics.id_true_positives,
+		metrics.id_true_positives + metrics.id_false_positives);
+	metrics.idr = ratio(metrics.id_true_positives,
+		metrics.id_true_positives + metrics.id_misses);
+	metrics.idf1 = ratio(2.0 * metrics.id_true_positives,
+		2.0 * metrics.id_true_positives + metrics.id_false_positives +
+		metrics.id_misses);
+}
+
+void addMetrics(MotMetrics & sum, const MotMetrics & metrics){
+
+	sum.frames += metrics.frames;
+	sum.ground_truth += metrics.ground_truth;
+	sum.true_positives += metrics.true_positives;
+	sum.false_positives += metrics.false_positives;
+	sum.misses += metrics.misses;
+	sum.id_switches += metrics.id_switches;
+	sum.fragmentations += metrics.fragmentations;
+	sum.iou_sum += metrics.iou_sum;
+	sum.trajectories += metrics.trajectories;
+	sum.mostly_tracked += metrics.mostly_tracked;
+	sum.partly_tracked += metrics.partly_tracked;
+	sum.mostly_lost += metrics.mostly_lost;
+
+	// Identities never continue across sequences, so the identity assignment
+	// of the union is the union of the assignments
+	sum.id_true_positives += metrics.id_true_positives;
+	sum.id_false_positives += metrics.id_false_positives;
+	sum.id_misses += metrics.id_misses;
+	computeScores(sum);
+}
+
+/******************************************************************************/
+
+ClearMot::ClearMot():
+	labels_(NULL),
+	type_(LABEL_OTHER),
+	neighbour_type_(LABEL_OTHER),
+	min_iou_(0.5),
+	counts_(),
+	hypotheses_(0)
+	{
+}
+
+ClearMot::~ClearMot(){
+
+}
+
+void ClearMot::init(const KittiLabels * labels, const std::string & class_name,
+	const double min_iou){
+
+	labels_ = labels;
+	class_name_ = class_name;
+	min_iou_ = min_iou;
+
+	// Neighbouring classes neither count as misses nor as false positives
+	type_ = KittiLabels::getType(class_name);
+	neighbour_type_ = LABEL_OTHER;
+	if(type_ == LABEL_CAR)
+		neighbour_type_ = LABEL_VAN;
+	else if(type_ == LABEL_PEDESTRIAN)
+		neighbour_type_ = LABEL_PERSON_SITTING;
+
+	reset();
+}
+
+void ClearMot::reset(){
+
+	counts_ = MotMetrics();
+	hypotheses_ = 0;
+	trajectories_.clear();
+	overlaps_.clear();
+}
+
+void ClearMot::addFrame(const int frame, const KittiRecord * tracks,
+	const int count){
+
+	counts_.frames++;
+
+	// Ground truth of the class and its neighbour, and DontCare regions
+	frame_labels_.clear();
+	dont_care_.clear();
+	int label_count = 0;
+	const KittiLabel * labels = labels_ ?
+		labels_->getFrame(frame, label_count) : NULL;
+	for(int i = 0; i < label_count; ++i){
+		if(labels[i].type == type_ || labels[i].type == neighbour_type_)
+			frame_labels_.push_back(&labels[i]);
+		else if(labels[i].type == LABEL_DONTCARE)
+			dont_care_.push_back(&labels[i]);
+	}
+
+	// Tracks of the class
+	frame_tracks_.clear();
+	for(int j = 0; j < count; ++j){
+		if(std::strncmp(tracks[j].name, class_name_.c_str(),
+			sizeof(tracks[j].name)) == 0)
+			frame_tracks_.push_back(&tracks[j]);
+	}
+
+	// Optimal assignment on IoU, pairs below the minimum only if nothing
+	// else is left
+	int n = frame_labels_.size();
+	int m = frame_tracks_.size();
+	Eigen::MatrixXd iou(n, m);
+	Eigen::MatrixXd cost(n, m);
+	for(int i = 0; i < n; ++i){
+		const KittiLabel & l = *frame_labels_[i];
+		for(int j = 0; j < m; ++j){
+			const KittiRecord & t = *frame_tracks_[j];
+			iou(i,j) = getIoU(l.left, l.top, l.right, l.bottom,
+				std::min(t.left, t.right), std::min(t.top, t.bottom),
+				std::max(t.left, t.right), std::max(t.top, t.bottom));
+			cost(i,j) = (iou(i,j) >= min_iou_) ? 1.0 - iou(i,j) :
+				INVALID_COST;
+		}
+	}
+	std::vector<int> row_to_col(n, -1);
+	if(n > 0 && m > 0)
+		Assignment::solve(cost, row_to_col);
+
+	// Ground truth: matches, misses, identity switches and fragmentations
+	std::vector<bool> label_ignored(n, false);
+	std::vector<int> track_state(m, 0);
+	enum{ UNMATCHED = 0, MATCHED = 1, IGNORED = 2 };
+	for(int i = 0; i < n; ++i){
+
+		const KittiLabel & l = *frame_labels_[i];
+		int j = row_to_col[i];
+		if(j >= 0 && cost(i,j) >= INVALID_COST)
+			j = -1;
+
+		// Tracks of ignored ground truth are ignored as well
+		label_ignored[i] = l.type == neighbour_type_ ||
+			l.truncated > MAX_TRUNCATION || l.occluded > MAX_OCCLUSION ||
+			l.bottom - l.top < MIN_HEIGHT;
+		if(label_ignored[i]){
+			if(j >= 0)
+				track_state[j] = IGNORED;
+			continue;
+		}
+
+		counts_.ground_truth++;
+		Trajectory & trajectory = trajectories_.insert(std::make_pair(l.id,
+			Trajectory{-1, false, false, 0, 0})).first->second;
+		trajectory.frames++;
+		if(j < 0){
+			counts_.misses++;
+			trajectory.tracked_last = false;
+			continue;
+		}
+
+		track_state[j] = MATCHED;
+		counts_.true_positives++;
+		counts_.iou_sum += iou(i,j);
+		trajectory.tracked++;
+		int id = frame_tracks_[j]->id;
+		if(trajectory.last_track >= 0 && trajectory.last_track != id)
+			counts_.id_switches++;
+		if(trajectory.tracked_before && !trajectory.tracked_last)
+			counts_.fragmentations++;
+		trajectory.last_track = id;
+		trajectory.tracked_before = true;
+		trajectory.tracked_last = true;
+	}
+
+	// Unmatched tracks: small ones and those in DontCare regions are ignored
+	for(int j = 0; j < m; ++j){
+		if(track_state[j] != UNMATCHED)
+			continue;
+		const KittiRecord & t = *frame_tracks_[j];
+		float left = std::min(t.left, t.right);
+		float right = std::max(t.left, t.right);
+		float top = std::min(t.top, t.bottom);
+		float bottom = std::max(t.top, t.bottom);
+		bool ignored = bottom - top < MIN_HEIGHT;
+		double area = getArea(left, top, right, bottom);
+		for(int d = 0; d < dont_care_.size() && !ignored; ++d){
+			const KittiLabel & l = *dont_care_[d];
+			ignored = ratio(getIntersection(left, top, right, bottom,
+				l.left, l.top, l.right, l.bottom), area) >= DONT_CARE_OVERLAP;
+		}
+		if(ignored){
+			track_state[j] = IGNORED;
+			continue;
+		}
+		counts_.false_positives++;
+	}
+
+	// Overlapping pairs of evaluated trajectories for the identity metrics
+	for(int j = 0; j < m; ++j){
+		if(track_state[j] == IGNORED)
+			continue;
+		hypotheses_++;
+		for(int i = 0; i < n; ++i){
+			if(!label_ignored[i] && iou(i,j) >= min_iou_)
+				overlaps_[std::make_pair(frame_labels_[i]->id,
+					frame_tracks_[j]->id)]++;
+		}
+	}
+}
+
+MotMetrics ClearMot::getCounts() const{
+
+	MotMetrics metrics = counts_;
+	computeScores(metrics);
+	return metrics;
+}
+
+MotMetrics ClearMot::getMetrics() const{
+
+	MotMetrics metrics = counts_;
+
+	// Share of tracked frames per ground truth trajectory
+	std::map<int, Trajectory>::const_iterator it;
+	for(it = trajectories_.begin(); it != trajectories_.end(); ++it){
+		double tracked = ratio(it->second.tracked, it->second.frames);
+		metrics.trajectories++;
+		if(tracked >= 0.8)
+			metrics.mostly_tracked++;
+		else if(tracked >= 0.2)
+			metrics.partly_tracked++;
+		else
+			metrics.mostly_lost++;
+	}
+
+	// One to one assignment of ground truth and track trajectories with the
+	// most overlapping frames, only overlapping ones can contribute
+	std::map<int, int> gt_index;
+	std::map<int, int> track_index;
+	std::map<std::pair<int, int>, int>::const_iterator o;
+	int max_overlap = 0;
+	for(o = overlaps_.begin(); o != overlaps_.end(); ++o){
+		gt_index.insert(std::make_pair(o->first.first, int(gt_index.size())));
+		track_index.insert(std::make_pair(o->first.second,
+			int(track_index.size())));
+		max_overlap = std::max(max_overlap, o->second);
+	}
+	Eigen::MatrixXd overlap = Eigen::MatrixXd::Zero(gt_index.size(),
+		track_index.size());
+	for(o = overlaps_.begin(); o != overlaps_.end(); ++o)
+		overlap(gt_index[o->first.first], track_index[o->first.second]) =
+			o->second;
+	std::vector<int> row_to_col(overlap.rows(), -1);
+	if(overlap.size() > 0){
+		Eigen::MatrixXd cost = Eigen::MatrixXd::Constant(overlap.rows(),
+			overlap.cols(), max_overlap) - overlap;
+		Assignment::solve(cost, row_to_col);
+	}
+	for(int i = 0; i < row_to_col.size(); ++i){
+		if(row_to_col[i] >= 0)
+			metrics.id_true_positives += overlap(i, row_to_col[i]);
+	}
+	metrics.id_false_positives = hypotheses_ - metrics.id_true_positives;
+	metrics.id_misses = metrics.ground_truth - metrics.id_true_positives;
+
+	computeScores(metrics);
+	return metrics;
+}
+
+} // namespace evaluation
@@ -6,6 +6,8 @@
  */
 
 #include <evaluation_lib/evaluation.h>
+#include <algorithm>
+#include <cstring>
 
 namespace evaluation{
 
@@ -29,14 +31,60 @@ Evaluation::Evaluation(ros::NodeHandle nh, ros::NodeHandle private_nh):
 		ROS_ERROR("Failed to read scenario");
 	}
 
+	// Result lines are written by a background thread
+	int flush_size;
+	double flush_interval;
+	int queue_size;
+	bool text;
+	bool binary;
+	std::string parameter_namespace;
+	private_nh_.param("writer/flush_size", flush_size, 65536);
+	private_nh_.param("writer/flush_interval", flush_interval, 1.0);
+	private_nh_.param("writer/queue_size", queue_size, 8192);
+	private_nh_.param("writer/text", text, true);
+	private_nh_.param("writer/binary", binary, true);
+	private_nh_.param("writer/parameter_namespace", parameter_namespace,
+		std::string("/tracking_node"));
+	ROS_INFO_STREAM("writer_flush_size " << flush_size);
+	ROS_INFO_STREAM("writer_flush_interval " << flush_interval);
+	ROS_INFO_STREAM("writer_queue_size " << queue_size);
+	ROS_INFO_STREAM("writer_text " << text);
+	ROS_INFO_STREAM("writer_binary " << binary);
+	ROS_INFO_STREAM("writer_parameter_namespace " << parameter_namespace);
+
 	// Delete content in file if there is one
 	filename_ = 
 		"~/kitti_results/"
 		+ scenario_name + ".txt";
-	tracking_results_.open(filename_.c_str(),
-		std::ofstream::out | std::ofstream::trunc);
+	if(text && !tracking_results_.start(filename_, flush_size,
+		flush_interval, queue_size))
+		ROS_WARN("Error opening file [%s]", filename_.c_str());
+
+	// Binary results with the scenario and the tracking parameters
+	std::string binary_filename =
+		"~/kitti_results/"
+		+ scenario_name + ".bin";
+	if(binary && !binary_results_.start(binary_filename, flush_size,
+		flush_interval, queue_size, ResultFile::createHeader(scenario_name,
+		getParameterText(parameter_namespace))))
+		ROS_WARN("Error opening file [%s]", binary_filename.c_str());
+
+	// Live metrics against the labels of the scenario
+	std::string labels;
+	double min_iou;
+	private_nh_.param("metrics/labels", labels, std::string(""));
+	private_nh_.param("metrics/min_iou", min_iou, 0.5);
+	ROS_INFO_STREAM("metrics_labels " << labels);
+	ROS_INFO_STREAM("metrics_min_iou " << min_iou);
+	metrics_ = !labels.empty() && labels_.load(labels);
+	if(metrics_){
+		car_metrics_.init(&labels_, "Car", min_iou);
+		ped_metrics_.init(&labels_, "Pedestrian", min_iou);
+	}
+	else if(!labels.empty()){
+		ROS_WARN("Error reading labels [%s]", labels.c_str());
+	}
 
-	tracking_results_.close();
 	// Subscriber
 	list_tracked_objects_sub_ = 
 		nh.subscribe("/tracking/objects", 1, &Evaluation::process, this);
@@ -47,55 +95,77 @@ Evaluation::Evaluation(ros::NodeHandle nh, ros::NodeHandle private_nh):
 
 Evaluation::~Evaluation(){
 
+	// Final metrics of the run
+	if(metrics_){
+		std::ostringstream car, ped;
+		printMetrics(car, "Car", car_metrics_.getMetrics());
+		printMetrics(ped, "Pedestrian", ped_metrics_.getMetrics());
+		ROS_INFO_STREAM(car.str());
+		ROS_INFO_STREAM(ped.str());
+	}
 }
 
 void Evaluation::process(const ObjectArray& tracks){
 
-	// Write results to file
-	tracking_results_.open(filename_.c_str(),
-		std::ofstream::ate | std::fstream::app);
-	if (tracking_results_.is_open()){
-		
-		for(int i = 0; i < tracks.list.size(); ++i){
-
-			// Grab track and get additional information
-			Object o = tracks.list[i];
-
-			// Transform
-			try{
-				geometry_msgs::PointStamped cam_pose;
-				cam_pose.header.frame_id = "camera_color_left";
-				o.world_pose.header.frame_id = "world";
-				listener_.transformPoint("camera_color_left",
-					o.world_pose,
-					cam_pose);
-				listener_.transformPoint("velo_link",
-					o.world_pose,
-					o.velo_pose);
-
-				// Width
-				MatrixXf bounding_box = tools_.getImage2DBoundingBox(o);
-
-				// Write information
-				tracking_results_ << time_frame_ << " " << o.id << " "
-					<< o.semantic_name << " 0 0 0 "
-					<< bounding_box(0,0) << " " << bounding_box(1,0) << " "
-					<< bounding_box(0,1) << " " << bounding_box(1,1) << " "
-					<< o.height << " " << o.width << " " << o.length << " "
-					<< cam_pose.point.x << " " << cam_pose.point.y << " "
-					<< cam_pose.point.z << " "
-					<< o.orientation << " " << o.semantic_confidence
-					<< "\n";
-			}
-			catch(tf::TransformException& ex){
-				ROS_ERROR("Received an exception trying to transform a point from"
-					"\"world\" to \"cam\": %s", ex.what());
-			}
+	// Transform all tracks with one lookup per frame
+	ObjectArray list = tracks;
+	try{
+		for(int i = 0; i < list.list.size(); ++i)
+			list.list[i].world_pose.header.frame_id = "world";
+		transforms_.transformObjects(list, &Object::world_pose,
+			"camera_color_left", &Object::cam_pose);
+		transforms_.transformObjects(list, &Object::world_pose,
+			"velo_link", &Object::velo_pose);
+	}
+	catch(tf::TransformException& ex){
+		ROS_ERROR("Received an exception trying to transform a point from"
+			"\"world\" to \"cam\": %s", ex.what());
+		list.list.clear();
+	}
+
+	// Binary block of the frame, also without tracks
+	if(binary_results_.isRunning()){
+		KittiFrameHeader block;
+		block.frame = time_frame_;
+		block.count = list.list.size();
+		ResultRecord & slot = binary_results_.next();
+		std::memcpy(slot.data, &block, sizeof(block));
+		slot.size = sizeof(block);
+		binary_results_.commit();
+	}
+
+	// Hand the results over to the writer threads, formatted in the slots
+	records_.resize(list.list.size());
+	for(int i = 0; i < list.list.size(); ++i){
+		KittiRecord & record = records_[i];
+		tools_.getKittiRecord(time_frame_, list.list[i],
+			list.list[i].cam_pose.point, record);
+		if(tracking_results_.isRunning()){
+			ResultRecord & slot = tracking_results_.next();
+			slot.size = Tools::formatKittiLine(slot.data, sizeof(slot.data),
+				record);
+			if(slot.size > 0)
+				tracking_results_.commit();
+		}
+		if(binary_results_.isRunning()){
+			ResultRecord & slot = binary_results_.next();
+			std::memcpy(slot.data, &record, sizeof(record));
+			slot.size = sizeof(record);
+			binary_results_.commit();
 		}
-		tracking_results_.close();
 	}
-	else{
-		ROS_WARN("Error opening file");
+
+	// Match the frame and report the counts so far, the identity metrics
+	// follow at the end of the run
+	if(metrics_){
+		car_metrics_.addFrame(time_frame_, records_.data(), records_.size());
+		ped_metrics_.addFrame(time_frame_, records_.data(), records_.size());
+		MotMetrics car = car_metrics_.getCounts();
+		MotMetrics ped = ped_metrics_.getCounts();
+		ROS_INFO("Metrics [%d]: Car MOTA [%f] MOTP [%f] IDS [%d],"
+			" Pedestrian MOTA [%f] MOTP [%f] IDS [%d]", time_frame_,
+			car.mota, car.motp, car.id_switches, ped.mota, ped.motp,
+			ped.id_switches);
 	}
 
 	// Print sensor fusion
@@ -105,4 +175,20 @@ void Evaluation::process(const ObjectArray& tracks){
 	time_frame_++;
 }
 
+std::string Evaluation::getParameterText(const std::string & prefix){
+
+	// One line per parameter below the prefix, sorted by name
+	std::vector<std::string> names;
+	ros::param::getParamNames(names);
+	std::sort(names.begin(), names.end());
+	std::ostringstream text;
+	for(int i = 0; i < names.size(); ++i){
+		XmlRpc::XmlRpcValue value;
+		if(names[i].compare(0, prefix.size(), prefix) == 0 &&
+			ros::param::get(names[i], value))
+			text << names[i] << " " << value << "\n";
+	}
+	return text.str();
+}
+
 } // namespace evaluation
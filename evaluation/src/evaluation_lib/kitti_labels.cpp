@@ -0,0 +1,268 @@
+#include <evaluation_lib/kitti_labels.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace evaluation{
+
+// Label offset in the cache file, aligned to 8 bytes
+static size_t getLabelOffset(const int frames){
+
+	size_t offset = sizeof(KittiLabelCacheHeader) +
+		size_t(frames + 1) * sizeof(int32_t);
+	return (offset + 7) / 8 * 8;
+}
+
+// Frame offsets start at 0, never decrease and end at the label count
+static bool isValidIndex(const int32_t * frame_begin, const uint32_t frames,
+	const uint32_t count){
+
+	if(frame_begin[0] != 0 || frame_begin[frames] != int64_t(count))
+		return false;
+	for(uint32_t f = 0; f < frames; ++f){
+		if(frame_begin[f] > frame_begin[f + 1])
+			return false;
+	}
+	return true;
+}
+
+/******************************************************************************/
+
+KittiLabels::KittiLabels():
+	labels_(NULL),
+	frame_begin_(NULL),
+	frames_(0),
+	count_(0),
+	data_(NULL),
+	size_(0)
+	{
+}
+
+KittiLabels::~KittiLabels(){
+
+	close();
+}
+
+bool KittiLabels::load(const std::string & filename, const bool cache){
+
+	close();
+
+	// Size and modification time of the label file identify the cache
+	struct stat info;
+	if(stat(filename.c_str(), &info) != 0)
+		return false;
+	KittiLabelCacheHeader key;
+	std::memset(&key, 0, sizeof(key));
+	key.magic = KITTI_LABEL_CACHE_MAGIC;
+	key.version = KITTI_LABEL_CACHE_VERSION;
+	key.label_size = sizeof(KittiLabel);
+	key.source_size = info.st_size;
+	key.source_mtime_sec = info.st_mtim.tv_sec;
+	key.source_mtime_nsec = info.st_mtim.tv_nsec;
+
+	std::string cache_filename = filename + ".cache";
+	if(cache && map(cache_filename, key))
+		return true;
+
+	if(!parse(filename))
+		return false;
+
+	// Build the cache and serve from it, otherwise from the parsed labels
+	if(cache && write(cache_filename, key) && map(cache_filename, key)){
+		std::vector<KittiLabel>().swap(parsed_labels_);
+		std::vector<int32_t>().swap(parsed_frame_begin_);
+	}
+	return true;
+}
+
+void KittiLabels::close(){
+
+	if(data_)
+		munmap(const_cast<char *>(data_), size_);
+	data_ = NULL;
+	size_ = 0;
+	labels_ = NULL;
+	frame_begin_ = NULL;
+	frames_ = 0;
+	count_ = 0;
+	parsed_labels_.clear();
+	parsed_frame_begin_.clear();
+}
+
+bool KittiLabels::parse(const std::string & filename){
+
+	std::ifstream file(filename.c_str());
+	if(!file.is_open())
+		return false;
+
+	// frame id type truncated occluded alpha left top right bottom ...
+	std::string line;
+	std::string type;
+	float alpha;
+	while(std::getline(file, line)){
+		std::istringstream stream(line);
+		KittiLabel label;
+		if(!(stream >> label.frame >> label.id >> type >> label.truncated >>
+			label.occluded >> alpha >> label.left >> label.top >>
+			label.right >> label.bottom) || label.frame < 0)
+			continue;
+		label.type = getType(type);
+		parsed_labels_.push_back(label);
+	}
+
+	index();
+	return true;
+}
+
+void KittiLabels::index(){
+
+	// Files are ordered by frame already, the sort keeps them stable
+	std::stable_sort(parsed_labels_.begin(), parsed_labels_.end(),
+		[](const KittiLabel & a, const KittiLabel & b){
+			return a.frame < b.frame; });
+
+	int frames = parsed_labels_.empty() ? 0 : parsed_labels_.back().frame + 1;
+	parsed_frame_begin_.assign(frames + 1, 0);
+	for(int i = 0; i < parsed_labels_.size(); ++i)
+		parsed_frame_begin_[parsed_labels_[i].frame + 1]++;
+	for(int f = 0; f < frames; ++f)
+		parsed_frame_begin_[f + 1] += parsed_frame_begin_[f];
+
+	labels_ = parsed_labels_.data();
+	frame_begin_ = parsed_frame_begin_.data();
+	frames_ = frames;
+	count_ = parsed_labels_.size();
+}
+
+bool KittiLabels::map(const std::string & filename,
+	const KittiLabelCacheHeader & key){
+
+	// Map the whole cache read only
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+	struct stat info;
+	if(fstat(fd, &info) != 0 ||
+		info.st_size < sizeof(KittiLabelCacheHeader)){
+		::close(fd);
+		return false;
+	}
+	void * data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(data == MAP_FAILED)
+		return false;
+
+	// Only a complete cache of this version and label file is used, with
+	// frame offsets inside the mapped labels
+	const KittiLabelCacheHeader & header =
+		*static_cast<const KittiLabelCacheHeader *>(data);
+	size_t max_frames = (info.st_size - sizeof(KittiLabelCacheHeader)) /
+		sizeof(int32_t);
+	if(header.magic != key.magic || header.version != key.version ||
+		header.label_size != key.label_size ||
+		header.source_size != key.source_size ||
+		header.source_mtime_sec != key.source_mtime_sec ||
+		header.source_mtime_nsec != key.source_mtime_nsec ||
+		header.frames >= max_frames ||
+		getLabelOffset(header.frames) + size_t(header.count) *
+		sizeof(KittiLabel) != info.st_size ||
+		!isValidIndex(reinterpret_cast<const int32_t *>(
+		static_cast<const char *>(data) + sizeof(KittiLabelCacheHeader)),
+		header.frames, header.count)){
+		munmap(data, info.st_size);
+		return false;
+	}
+
+	data_ = static_cast<const char *>(data);
+	size_ = info.st_size;
+	frames_ = header.frames;
+	count_ = header.count;
+	frame_begin_ = reinterpret_cast<const int32_t *>(data_ +
+		sizeof(KittiLabelCacheHeader));
+	labels_ = reinterpret_cast<const KittiLabel *>(data_ +
+		getLabelOffset(frames_));
+	return true;
+}
+
+bool KittiLabels::write(const std::string & filename,
+	const KittiLabelCacheHeader & key) const{
+
+	KittiLabelCacheHeader header = key;
+	header.frames = frames_;
+	header.count = count_;
+	std::string bytes(reinterpret_cast<const char *>(&header),
+		sizeof(header));
+	bytes.append(reinterpret_cast<const char *>(frame_begin_),
+		size_t(frames_ + 1) * sizeof(int32_t));
+	bytes.resize(getLabelOffset(frames_), '\0');
+	bytes.append(reinterpret_cast<const char *>(labels_),
+		size_t(count_) * sizeof(KittiLabel));
+
+	// Write to a unique file and rename it, so concurrent loads of any
+	// process or thread never map a partial cache
+	std::string temporary = filename + ".XXXXXX";
+	int fd = mkstemp(&temporary[0]);
+	if(fd < 0)
+		return false;
+	bool written = fchmod(fd, 0644) == 0;
+	for(size_t done = 0; written && done < bytes.size();){
+		ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+		written = n > 0;
+		done += written ? n : 0;
+	}
+	written = ::close(fd) == 0 && written;
+	if(!written || std::rename(temporary.c_str(), filename.c_str()) != 0){
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+int KittiLabels::getType(const std::string & name){
+
+	if(name == "Car")
+		return LABEL_CAR;
+	if(name == "Van")
+		return LABEL_VAN;
+	if(name == "Pedestrian")
+		return LABEL_PEDESTRIAN;
+	if(name == "Person_sitting")
+		return LABEL_PERSON_SITTING;
+	if(name == "DontCare")
+		return LABEL_DONTCARE;
+	return LABEL_OTHER;
+}
+
+int KittiLabels::getNumberOfFrames() const{
+
+	return frames_;
+}
+
+int KittiLabels::size() const{
+
+	return count_;
+}
+
+bool KittiLabels::isMapped() const{
+
+	return data_ != NULL;
+}
+
+const KittiLabel * KittiLabels::getFrame(const int frame, int & count) const{
+
+	if(frame < 0 || frame >= getNumberOfFrames()){
+		count = 0;
+		return NULL;
+	}
+	count = frame_begin_[frame + 1] - frame_begin_[frame];
+	return labels_ + frame_begin_[frame];
+}
+
+} // namespace evaluation
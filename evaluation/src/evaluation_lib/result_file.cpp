@@ -0,0 +1,150 @@
+#include <evaluation_lib/result_file.h>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace evaluation{
+
+// Blocks start at multiples of this
+static const size_t ALIGNMENT = 8;
+
+static size_t padded(const size_t size){
+
+	return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+/******************************************************************************/
+
+ResultFile::ResultFile():
+	data_(NULL),
+	size_(0)
+	{
+}
+
+ResultFile::~ResultFile(){
+
+	close();
+}
+
+bool ResultFile::open(const std::string & filename){
+
+	close();
+
+	// Map the whole file read only
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size < sizeof(KittiFileHeader)){
+		::close(fd);
+		return false;
+	}
+	void * data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(data == MAP_FAILED)
+		return false;
+	data_ = static_cast<const char *>(data);
+	size_ = info.st_size;
+
+	if(!index()){
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ResultFile::close(){
+
+	if(data_)
+		munmap(const_cast<char *>(data_), size_);
+	data_ = NULL;
+	size_ = 0;
+	blocks_.clear();
+}
+
+bool ResultFile::index(){
+
+	// Header of this version
+	const KittiFileHeader & header =
+		*reinterpret_cast<const KittiFileHeader *>(data_);
+	if(header.magic != KITTI_RECORD_MAGIC ||
+		header.version != KITTI_RECORD_VERSION ||
+		header.record_size != sizeof(KittiRecord))
+		return false;
+
+	size_t offset = padded(sizeof(KittiFileHeader) + header.parameter_size);
+	if(offset > size_)
+		return false;
+
+	// Walk the frame blocks, a block cut off at the end of a run that did not
+	// stop cleanly is left out
+	while(offset + sizeof(KittiFrameHeader) <= size_){
+		const KittiFrameHeader & frame =
+			*reinterpret_cast<const KittiFrameHeader *>(data_ + offset);
+		size_t end = offset + sizeof(KittiFrameHeader) +
+			size_t(frame.count) * sizeof(KittiRecord);
+		if(end > size_)
+			break;
+		blocks_.push_back(offset);
+		offset = end;
+	}
+	return true;
+}
+
+std::string ResultFile::createHeader(const std::string & scenario,
+	const std::string & parameters){
+
+	KittiFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	header.magic = KITTI_RECORD_MAGIC;
+	header.version = KITTI_RECORD_VERSION;
+	header.record_size = sizeof(KittiRecord);
+	header.parameter_size = parameters.size();
+	std::strncpy(header.scenario, scenario.c_str(),
+		sizeof(header.scenario) - 1);
+
+	std::string bytes(reinterpret_cast<const char *>(&header),
+		sizeof(header));
+	bytes += parameters;
+	bytes.resize(padded(bytes.size()), '\0');
+	return bytes;
+}
+
+std::string ResultFile::getScenario() const{
+
+	const KittiFileHeader & header =
+		*reinterpret_cast<const KittiFileHeader *>(data_);
+	return std::string(header.scenario,
+		strnlen(header.scenario, sizeof(header.scenario)));
+}
+
+std::string ResultFile::getParameters() const{
+
+	const KittiFileHeader & header =
+		*reinterpret_cast<const KittiFileHeader *>(data_);
+	return std::string(data_ + sizeof(KittiFileHeader),
+		header.parameter_size);
+}
+
+int ResultFile::getNumberOfFrames() const{
+
+	return blocks_.size();
+}
+
+int ResultFile::getFrame(const int k) const{
+
+	return reinterpret_cast<const KittiFrameHeader *>(
+		data_ + blocks_[k])->frame;
+}
+
+const KittiRecord * ResultFile::getRecords(const int k, int & count) const{
+
+	const KittiFrameHeader * frame =
+		reinterpret_cast<const KittiFrameHeader *>(data_ + blocks_[k]);
+	count = frame->count;
+	return reinterpret_cast<const KittiRecord *>(frame + 1);
+}
+
+} // namespace evaluation
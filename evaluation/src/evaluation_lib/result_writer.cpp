@@ -0,0 +1,122 @@
+#include <evaluation_lib/result_writer.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace evaluation{
+
+/******************************************************************************/
+
+ResultWriter::ResultWriter():
+	flush_size_(0),
+	flush_interval_(0.0),
+	stop_(false),
+	running_(false),
+	stalls_(0)
+	{
+}
+
+ResultWriter::~ResultWriter(){
+
+	stop();
+}
+
+bool ResultWriter::start(const std::string & filename, const int flush_size,
+	const double flush_interval, const int queue_size,
+	const std::string & header){
+
+	stop();
+	file_.open(filename.c_str(), std::ofstream::out | std::ofstream::trunc |
+		std::ofstream::binary);
+	if(!file_.is_open())
+		return false;
+	file_.write(header.data(), header.size());
+
+	flush_size_ = std::max(1, flush_size);
+	flush_interval_ = flush_interval;
+	queue_.reset(new SpscQueue<ResultRecord>(std::max(1, queue_size)));
+	stalls_ = 0;
+	stop_ = false;
+	running_ = true;
+	thread_ = std::thread(&ResultWriter::run, this);
+	return true;
+}
+
+void ResultWriter::stop(){
+
+	if(!running_)
+		return;
+
+	// The writer drains the queue before it returns
+	stop_.store(true, std::memory_order_release);
+	thread_.join();
+	file_.close();
+	queue_.reset();
+	running_ = false;
+}
+
+ResultRecord & ResultWriter::next(){
+
+	ResultRecord * record = queue_->front();
+	if(!record){
+		stalls_++;
+		while(!(record = queue_->front()))
+			std::this_thread::yield();
+	}
+	return *record;
+}
+
+void ResultWriter::commit(){
+
+	queue_->push();
+}
+
+bool ResultWriter::isRunning() const{
+
+	return running_;
+}
+
+int ResultWriter::getStalls() const{
+
+	return stalls_;
+}
+
+void ResultWriter::run(){
+
+	typedef std::chrono::steady_clock Clock;
+	std::vector<char> buffer;
+	buffer.reserve(flush_size_ + Tools::KITTI_LINE_SIZE);
+	Clock::time_point last_flush = Clock::now();
+	while(true){
+
+		// Lines pushed before the stop request are still collected
+		bool stopping = stop_.load(std::memory_order_acquire);
+		bool idle = true;
+		while(ResultRecord * record = queue_->peek()){
+			buffer.insert(buffer.end(), record->data,
+				record->data + record->size);
+			queue_->pop();
+			idle = false;
+			if(buffer.size() >= flush_size_)
+				break;
+		}
+
+		// Write on size, time and stop
+		double elapsed = std::chrono::duration<double>(
+			Clock::now() - last_flush).count();
+		if(!buffer.empty() && (buffer.size() >= flush_size_ ||
+			elapsed >= flush_interval_ || stopping)){
+			file_.write(buffer.data(), buffer.size());
+			file_.flush();
+			buffer.clear();
+			last_flush = Clock::now();
+		}
+
+		if(stopping && !queue_->peek())
+			return;
+		if(idle)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+} // namespace evaluation
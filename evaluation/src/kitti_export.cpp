@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Exports binary tracking results as KITTI tracking text, byte for byte as
+ * written by the evaluation node.
+ * Usage: rosrun evaluation kitti_export results.bin [results.txt]
+ *
+ */
+
+#include <evaluation_lib/result_file.h>
+#include <helper/tools.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace evaluation;
+
+// Bytes collected before each write
+static const size_t WRITE_SIZE = 1 << 20;
+
+int main(int argc, char **argv){
+
+	if(argc < 2){
+		std::fprintf(stderr, "Usage: kitti_export results.bin [results.txt]\n");
+		return 1;
+	}
+
+	// Output next to the input by default
+	std::string input = argv[1];
+	std::string output = (argc > 2) ? argv[2] :
+		input.substr(0, input.rfind('.')) + ".txt";
+
+	ResultFile results;
+	if(!results.open(input)){
+		std::fprintf(stderr, "Could not read results [%s]\n", input.c_str());
+		return 1;
+	}
+	std::ofstream file(output.c_str(),
+		std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+	if(!file.is_open()){
+		std::fprintf(stderr, "Could not write [%s]\n", output.c_str());
+		return 1;
+	}
+
+	// Format all records of all frames in order
+	std::vector<char> buffer;
+	buffer.reserve(WRITE_SIZE + Tools::KITTI_LINE_SIZE);
+	char line[Tools::KITTI_LINE_SIZE];
+	int lines = 0;
+	for(int k = 0; k < results.getNumberOfFrames(); ++k){
+		int count;
+		const KittiRecord * records = results.getRecords(k, count);
+		for(int i = 0; i < count; ++i){
+			int length = Tools::formatKittiLine(line, sizeof(line), records[i]);
+			if(length < 0)
+				continue;
+			buffer.insert(buffer.end(), line, line + length);
+			lines++;
+		}
+		if(buffer.size() >= WRITE_SIZE){
+			file.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+	file.write(buffer.data(), buffer.size());
+	file.close();
+	if(!file){
+		std::fprintf(stderr, "Could not write [%s]\n", output.c_str());
+		return 1;
+	}
+
+	std::printf("Exported scenario [%s]: %d frames, %d lines to [%s]\n",
+		results.getScenario().c_str(), results.getNumberOfFrames(), lines,
+		output.c_str());
+	return 0;
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+ *
+ * CLEAR MOT and identity metrics of binary tracking results against the
+ * KITTI tracking labels of the sequence.
+ * Usage: rosrun evaluation kitti_metrics results.bin label_02/0060.txt
+ *        [min_iou]
+ *
+ */
+
+#include <evaluation_lib/clear_mot.h>
+#include <evaluation_lib/result_file.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace evaluation;
+
+int main(int argc, char **argv){
+
+	if(argc < 3){
+		std::fprintf(stderr, "Usage: kitti_metrics results.bin labels.txt"
+			" [min_iou]\n");
+		return 1;
+	}
+	double min_iou = (argc > 3) ? std::atof(argv[3]) : 0.5;
+
+	// Load results and ground truth
+	ResultFile results;
+	if(!results.open(argv[1])){
+		std::fprintf(stderr, "Could not read results [%s]\n", argv[1]);
+		return 1;
+	}
+	KittiLabels labels;
+	if(!labels.load(argv[2])){
+		std::fprintf(stderr, "Could not read labels [%s]\n", argv[2]);
+		return 1;
+	}
+
+	// Evaluate all frames of the results for both classes
+	ClearMot car;
+	ClearMot pedestrian;
+	car.init(&labels, "Car", min_iou);
+	pedestrian.init(&labels, "Pedestrian", min_iou);
+	for(int k = 0; k < results.getNumberOfFrames(); ++k){
+		int count;
+		const KittiRecord * records = results.getRecords(k, count);
+		car.addFrame(results.getFrame(k), records, count);
+		pedestrian.addFrame(results.getFrame(k), records, count);
+	}
+
+	std::cout << "Scenario [" << results.getScenario() << "] "
+		<< results.getNumberOfFrames() << " frames\n";
+	printMetrics(std::cout, "Car", car.getMetrics());
+	std::cout << "\n";
+	printMetrics(std::cout, "Pedestrian", pedestrian.getMetrics());
+	std::cout << "\n";
+	return 0;
+}
@@ -0,0 +1,246 @@
+#include <evaluation_lib/clear_mot.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace evaluation;
+
+// Frames of the synthetic sequence
+static const int FRAMES = 10;
+
+// Synthetic sequence of 10 frames. Car 1 moves right, car 2 is partly
+// occluded, the van and the DontCare region are ignored for cars.
+class ClearMotTest : public ::testing::Test{
+
+protected:
+
+	virtual void SetUp(){
+
+		char path[] = "/tmp/clear_mot_XXXXXX";
+		int fd = mkstemp(path);
+		ASSERT_GE(fd, 0);
+		close(fd);
+		filename_ = path;
+
+		std::ofstream file(filename_.c_str());
+		for(int f = 0; f < FRAMES; ++f){
+			file << f << " 1 Car 0 0 0 " << 100 + f
+				<< " 100 200 200 0 0 0 0 0 0 0\n";
+			file << f << " 2 Car 0 1 0 400 100 500 200 0 0 0 0 0 0 0\n";
+			file << f << " 3 Van 0 0 0 600 100 700 200 0 0 0 0 0 0 0\n";
+			file << f << " -1 DontCare -1 -1 -10 800 100 900 200"
+				" -1 -1 -1 -1000 -1000 -1000 -10\n";
+			file << f << " 4 Pedestrian 0 0 0 50 300 70 360 0 0 0 0 0 0 0\n";
+		}
+		file.close();
+	}
+
+	virtual void TearDown(){
+
+		std::remove(filename_.c_str());
+		std::remove((filename_ + ".cache").c_str());
+	}
+
+	static KittiRecord createRecord(const int frame, const int id,
+		const char * name, const float left, const float top,
+		const float right, const float bottom){
+
+		KittiRecord record;
+		std::memset(&record, 0, sizeof(record));
+		record.frame = frame;
+		record.id = id;
+		std::strncpy(record.name, name, sizeof(record.name) - 1);
+		record.left = left;
+		record.top = top;
+		record.right = right;
+		record.bottom = bottom;
+		return record;
+	}
+
+	// Tracks of all frames for both classes
+	void evaluate(const KittiLabels & labels, MotMetrics & car,
+		MotMetrics & ped) const{
+
+		ClearMot car_mot;
+		ClearMot ped_mot;
+		car_mot.init(&labels, "Car");
+		ped_mot.init(&labels, "Pedestrian");
+		for(int f = 0; f < FRAMES; ++f){
+
+			std::vector<KittiRecord> tracks;
+
+			// Car 1 changes its track id after frame 4
+			tracks.push_back(createRecord(f, f < 5 ? 10 : 11, "Car",
+				102 + f, 101, 201 + f, 199));
+
+			// Car 2 is lost in frames 3 and 4
+			if(f != 3 && f != 4)
+				tracks.push_back(createRecord(f, 20, "Car", 400, 100, 500, 200));
+
+			// Tracks on the van and in the DontCare region are ignored, a false
+			// positive in frame 0
+			tracks.push_back(createRecord(f, 30, "Car", 600, 100, 700, 200));
+			tracks.push_back(createRecord(f, 31, "Car", 810, 110, 890, 190));
+			if(f == 0)
+				tracks.push_back(createRecord(f, 32, "Car", 1000, 100, 1100,
+					200));
+
+			tracks.push_back(createRecord(f, 40, "Pedestrian", 50, 300, 70,
+				360));
+
+			car_mot.addFrame(f, tracks.data(), tracks.size());
+			ped_mot.addFrame(f, tracks.data(), tracks.size());
+		}
+		car = car_mot.getMetrics();
+		ped = ped_mot.getMetrics();
+	}
+
+	std::string filename_;
+};
+
+TEST_F(ClearMotTest, CarMetrics){
+
+	KittiLabels labels;
+	ASSERT_TRUE(labels.load(filename_, false));
+	ASSERT_EQ(labels.getNumberOfFrames(), FRAMES);
+
+	MotMetrics car, ped;
+	evaluate(labels, car, ped);
+
+	EXPECT_EQ(car.frames, FRAMES);
+	EXPECT_EQ(car.ground_truth, 20);
+	EXPECT_EQ(car.true_positives, 18);
+	EXPECT_EQ(car.false_positives, 1);
+	EXPECT_EQ(car.misses, 2);
+	EXPECT_EQ(car.id_switches, 1);
+	EXPECT_EQ(car.fragmentations, 1);
+	EXPECT_EQ(car.id_true_positives, 13);
+	EXPECT_NEAR(car.mota, 0.8, 1e-9);
+	EXPECT_NEAR(car.idf1, 2.0 / 3.0, 1e-9);
+}
+
+TEST_F(ClearMotTest, CountsWithoutIdentities){
+
+	KittiLabels labels;
+	ASSERT_TRUE(labels.load(filename_, false));
+
+	// Counts of the frame report against the full metrics
+	ClearMot car_mot;
+	car_mot.init(&labels, "Car");
+	for(int f = 0; f < FRAMES; ++f){
+		std::vector<KittiRecord> tracks;
+		tracks.push_back(createRecord(f, 10, "Car", 100 + f, 100, 200, 200));
+		car_mot.addFrame(f, tracks.data(), tracks.size());
+	}
+	MotMetrics counts = car_mot.getCounts();
+	MotMetrics metrics = car_mot.getMetrics();
+	EXPECT_EQ(counts.true_positives, metrics.true_positives);
+	EXPECT_EQ(counts.misses, metrics.misses);
+	EXPECT_DOUBLE_EQ(counts.mota, metrics.mota);
+	EXPECT_DOUBLE_EQ(counts.motp, metrics.motp);
+	EXPECT_EQ(counts.trajectories, 0);
+	EXPECT_EQ(counts.id_true_positives, 0);
+}
+
+TEST_F(ClearMotTest, PedestrianMetrics){
+
+	KittiLabels labels;
+	ASSERT_TRUE(labels.load(filename_, false));
+
+	MotMetrics car, ped;
+	evaluate(labels, car, ped);
+
+	EXPECT_EQ(ped.ground_truth, FRAMES);
+	EXPECT_EQ(ped.true_positives, FRAMES);
+	EXPECT_EQ(ped.false_positives, 0);
+	EXPECT_EQ(ped.misses, 0);
+	EXPECT_EQ(ped.id_switches, 0);
+	EXPECT_DOUBLE_EQ(ped.mota, 1.0);
+	EXPECT_DOUBLE_EQ(ped.motp, 1.0);
+	EXPECT_DOUBLE_EQ(ped.idf1, 1.0);
+}
+
+TEST_F(ClearMotTest, CachedLabels){
+
+	// Parsed labels against the cache written by the first load
+	KittiLabels parsed;
+	ASSERT_TRUE(parsed.load(filename_, false));
+	KittiLabels written;
+	ASSERT_TRUE(written.load(filename_));
+	KittiLabels mapped;
+	ASSERT_TRUE(mapped.load(filename_));
+	EXPECT_TRUE(mapped.isMapped());
+	ASSERT_EQ(mapped.size(), parsed.size());
+
+	MotMetrics car, ped, car_mapped, ped_mapped;
+	evaluate(parsed, car, ped);
+	evaluate(mapped, car_mapped, ped_mapped);
+	EXPECT_EQ(car_mapped.true_positives, car.true_positives);
+	EXPECT_EQ(car_mapped.id_switches, car.id_switches);
+	EXPECT_DOUBLE_EQ(car_mapped.mota, car.mota);
+	EXPECT_DOUBLE_EQ(ped_mapped.idf1, ped.idf1);
+}
+
+TEST_F(ClearMotTest, CorruptCacheIsRebuilt){
+
+	KittiLabels parsed;
+	ASSERT_TRUE(parsed.load(filename_, false));
+	KittiLabels written;
+	ASSERT_TRUE(written.load(filename_));
+	written.close();
+
+	// Offset of frame 1 far beyond the labels, the header still matches
+	{
+		std::fstream cache((filename_ + ".cache").c_str(),
+			std::ios::in | std::ios::out | std::ios::binary);
+		ASSERT_TRUE(cache.is_open());
+		int32_t offset = 1 << 30;
+		cache.seekp(sizeof(KittiLabelCacheHeader) + sizeof(int32_t));
+		cache.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+	}
+
+	KittiLabels rebuilt;
+	ASSERT_TRUE(rebuilt.load(filename_));
+	EXPECT_TRUE(rebuilt.isMapped());
+	ASSERT_EQ(rebuilt.size(), parsed.size());
+	for(int f = 0; f < FRAMES; ++f){
+		int count, parsed_count;
+		rebuilt.getFrame(f, count);
+		parsed.getFrame(f, parsed_count);
+		EXPECT_EQ(count, parsed_count);
+	}
+}
+
+TEST_F(ClearMotTest, ConcurrentCacheWrites){
+
+	// Threads of one process building the same cache at once
+	std::vector<std::thread> threads;
+	bool loaded[8];
+	int sizes[8];
+	for(int t = 0; t < 8; ++t){
+		threads.push_back(std::thread([&, t](){
+			KittiLabels labels;
+			loaded[t] = labels.load(filename_);
+			sizes[t] = labels.size();
+		}));
+	}
+	for(int t = 0; t < threads.size(); ++t)
+		threads[t].join();
+
+	for(int t = 0; t < 8; ++t){
+		EXPECT_TRUE(loaded[t]);
+		EXPECT_EQ(sizes[t], 5 * FRAMES);
+	}
+	KittiLabels mapped;
+	ASSERT_TRUE(mapped.load(filename_));
+	EXPECT_TRUE(mapped.isMapped());
+}
+
+int main(int argc, char ** argv){
+
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,21 @@
+// Include guard
+#ifndef assignment_H
+#define assignment_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+// Minimum cost assignment of the rows and columns of a dense cost matrix
+class Assignment{
+
+public:
+
+	// Assign every row to a column if rows <= cols and every column to a row
+	// otherwise, by shortest augmenting paths (Jonker-Volgenant). Unassigned
+	// rows are -1, returns the total cost.
+	static double solve(const Eigen::MatrixXd & cost,
+		std::vector<int> & row_to_col);
+
+};
+
+#endif // assignment_H
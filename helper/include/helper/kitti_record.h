@@ -0,0 +1,62 @@
+// Include guard
+#ifndef kitti_record_H
+#define kitti_record_H
+
+#include <stdint.h>
+
+// Binary tracking results, little endian, all blocks aligned to 8 bytes:
+//   KittiFileHeader
+//   parameter text of parameter_size bytes, zero padded to 8 bytes
+//   per frame: KittiFrameHeader followed by count KittiRecord
+static const uint32_t KITTI_RECORD_MAGIC = 0x4252544b; // "KTRB"
+static const uint32_t KITTI_RECORD_VERSION = 1;
+
+struct KittiFileHeader{
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t parameter_size;
+	char scenario[16];
+};
+
+struct KittiFrameHeader{
+
+	int32_t frame;
+	uint32_t count;
+};
+
+// One line of the KITTI tracking results with the values as written
+struct KittiRecord{
+
+	// Position in the camera frame
+	double x;
+	double y;
+	double z;
+
+	// Image bounding box
+	float left;
+	float top;
+	float right;
+	float bottom;
+
+	// Geometry and confidence
+	float height;
+	float width;
+	float length;
+	float orientation;
+	float confidence;
+
+	int32_t frame;
+	int32_t id;
+	uint32_t semantic_id;
+
+	// Zero terminated class name
+	char name[16];
+};
+
+static_assert(sizeof(KittiFileHeader) == 32, "Unexpected header layout");
+static_assert(sizeof(KittiFrameHeader) == 8, "Unexpected frame layout");
+static_assert(sizeof(KittiRecord) == 88, "Unexpected record layout");
+
+#endif // kitti_record_H
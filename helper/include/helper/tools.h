@@ -1,7 +1,14 @@
+// Include guard
+#ifndef tools_H
+#define tools_H
+
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 #include <geometry_msgs/Point.h>
 #include <helper/Object.h>
+#include <helper/Footprint.h>
+#include <helper/kitti_record.h>
+#include <ostream>
 
 using namespace Eigen;
 using namespace geometry_msgs;
@@ -29,6 +36,32 @@ public:
 
 	int getClusterKernel(const int semantic);
 
+	// Maximum length of a KITTI tracking result line
+	static const int KITTI_LINE_SIZE = 512;
+
+	// KITTI tracking result line of an object with velo pose set and its
+	// position in the camera frame
+	void writeKittiLine(std::ostream & stream, const int frame,
+		const Object & o, const Point & cam_point);
+
+	// Same line formatted into a buffer without a stream, returns its length
+	// or -1 if it does not fit
+	int formatKittiLine(char * buffer, const int size, const int frame,
+		const Object & o, const Point & cam_point);
+
+	// Values of the KITTI tracking result line as binary record, class names
+	// are cut to 15 characters
+	void getKittiRecord(const int frame, const Object & o,
+		const Point & cam_point, KittiRecord & record);
+
+	// KITTI tracking result line of a binary record
+	static int formatKittiLine(char * buffer, const int size,
+		const KittiRecord & record);
+
+	// Footprint functions
+	int getFootprintArea(const Footprint & f);
+	float getFootprintIoU(const Footprint & a, const Footprint & b);
+
 	// Semantic helpers
 	std::vector<std::string> SEMANTIC_NAMES;
 	std::map<int, int> SEMANTIC_COLOR_TO_CLASS;
@@ -42,4 +75,6 @@ private:
 	MatrixXf TRANS_CAM_TO_RECTCAM;
 	MatrixXf TRANS_RECTCAM_TO_IMAGE;
 
-};
\ No newline at end of file
+};
+
+#endif // tools_H
@@ -0,0 +1,92 @@
+// Include guard
+#ifndef transform_cache_H
+#define transform_cache_H
+
+#include <Eigen/Dense>
+#include <boost/shared_ptr.hpp>
+#include <geometry_msgs/PointStamped.h>
+#include <helper/ObjectArray.h>
+#include <tf/transform_listener.h>
+#include <string>
+#include <vector>
+
+// Looks up transforms once per frame pair and stamp and applies them as 4x4
+// matrices. Recent stamped lookups are kept, lookups of the latest transform
+// (zero stamp) only hold within one call. Lookup errors throw
+// tf::TransformException like tf::TransformListener::transformPoint.
+class TransformCache{
+
+public:
+
+	// Use a listener, by default the one shared by all nodelets of the process
+	explicit TransformCache(
+		const boost::shared_ptr<tf::TransformListener> & listener =
+		sharedListener());
+
+	// Listener of the process, created on first use and released with the
+	// last cache using it, so nodelets of one manager share one tf buffer
+	static boost::shared_ptr<tf::TransformListener> sharedListener();
+
+	// Transform from the source frame into the target frame at a stamp
+	const Eigen::Matrix4d & lookup(const std::string & target_frame,
+		const std::string & source_frame, const ros::Time & stamp);
+
+	// Transform one point like tf::TransformListener::transformPoint
+	void transformPoint(const std::string & target_frame,
+		const geometry_msgs::PointStamped & in,
+		geometry_msgs::PointStamped & out);
+
+	// Transform one pose of all objects into another pose, with one lookup
+	// per source frame and stamp
+	void transformObjects(helper::ObjectArray & objects,
+		geometry_msgs::PointStamped helper::Object::* source,
+		const std::string & target_frame,
+		geometry_msgs::PointStamped helper::Object::* target);
+
+	// Apply a transform to a point
+	static void apply(const Eigen::Matrix4d & T,
+		const geometry_msgs::Point & in, geometry_msgs::Point & out){
+		Eigen::Vector3d p = T.topLeftCorner<3, 3>() *
+			Eigen::Vector3d(in.x, in.y, in.z) + T.topRightCorner<3, 1>();
+		out.x = p(0);
+		out.y = p(1);
+		out.z = p(2);
+	}
+
+	// Remove all cached transforms
+	void clear();
+
+	// Getter
+	int getLookups() const;
+	int getHits() const;
+
+private:
+
+	struct Entry{
+
+		std::string target_frame;
+		std::string source_frame;
+		ros::Time stamp;
+		Eigen::Matrix4d T;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	boost::shared_ptr<tf::TransformListener> listener_;
+
+	// Ring of recent stamped transforms and the last latest transform
+	std::vector<Entry, Eigen::aligned_allocator<Entry> > entries_;
+	int next_;
+	Entry latest_;
+	bool has_latest_;
+
+	// Statistics
+	int lookups_;
+	int hits_;
+
+	const Eigen::Matrix4d & find(const std::string & target_frame,
+		const std::string & source_frame, const ros::Time & stamp,
+		const bool keep_latest);
+};
+
+#endif // transform_cache_H
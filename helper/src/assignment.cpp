@@ -0,0 +1,90 @@
+#include <helper/assignment.h>
+#include <limits>
+
+double Assignment::solve(const Eigen::MatrixXd & cost,
+	std::vector<int> & row_to_col){
+
+	row_to_col.assign(cost.rows(), -1);
+
+	// More rows than columns, assign the columns instead
+	if(cost.rows() > cost.cols()){
+		std::vector<int> col_to_row;
+		double total = solve(cost.transpose(), col_to_row);
+		for(int j = 0; j < col_to_row.size(); ++j)
+			row_to_col[col_to_row[j]] = j;
+		return total;
+	}
+
+	// Potentials of rows and columns, column 0 is a virtual start column
+	int n = cost.rows();
+	int m = cost.cols();
+	const double inf = std::numeric_limits<double>::infinity();
+	std::vector<double> u(n + 1, 0.0);
+	std::vector<double> v(m + 1, 0.0);
+	std::vector<int> col_row(m + 1, 0);
+	std::vector<int> way(m + 1, 0);
+	std::vector<double> min_v(m + 1);
+	std::vector<bool> used(m + 1);
+
+	// Add rows one by one along a shortest augmenting path
+	for(int i = 1; i <= n; ++i){
+
+		col_row[0] = i;
+		int j0 = 0;
+		std::fill(min_v.begin(), min_v.end(), inf);
+		std::fill(used.begin(), used.end(), false);
+
+		do{
+			used[j0] = true;
+			int i0 = col_row[j0];
+			double delta = inf;
+			int j1 = 0;
+
+			// Reduced costs of the columns not on the path yet
+			for(int j = 1; j <= m; ++j){
+				if(used[j])
+					continue;
+				double reduced = cost(i0 - 1, j - 1) - u[i0] - v[j];
+				if(reduced < min_v[j]){
+					min_v[j] = reduced;
+					way[j] = j0;
+				}
+				if(min_v[j] < delta){
+					delta = min_v[j];
+					j1 = j;
+				}
+			}
+
+			// Update potentials
+			for(int j = 0; j <= m; ++j){
+				if(used[j]){
+					u[col_row[j]] += delta;
+					v[j] -= delta;
+				}
+				else{
+					min_v[j] -= delta;
+				}
+			}
+			j0 = j1;
+		}
+		while(col_row[j0] != 0);
+
+		// Flip assignments along the path
+		do{
+			int j1 = way[j0];
+			col_row[j0] = col_row[j1];
+			j0 = j1;
+		}
+		while(j0 != 0);
+	}
+
+	// Read assignment
+	double total = 0.0;
+	for(int j = 1; j <= m; ++j){
+		if(col_row[j] != 0){
+			row_to_col[col_row[j] - 1] = j - 1;
+			total += cost(col_row[j] - 1, j - 1);
+		}
+	}
+	return total;
+}
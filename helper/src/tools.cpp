@@ -1,4 +1,6 @@
 #include <helper/tools.h>
+#include <cstdio>
+#include <cstring>
 
 Tools::Tools(){
 
@@ -90,6 +92,46 @@ int Tools::getClusterKernel(const int semantic){
 		return -1;
 }
 
+int Tools::getFootprintArea(const Footprint & f){
+
+	int area = 0;
+	for(int i = 0; i < f.row.size(); ++i)
+		area += f.col_end[i] - f.col_begin[i];
+	return area;
+}
+
+float Tools::getFootprintIoU(const Footprint & a, const Footprint & b){
+
+	// Walk both sorted run lists once and sum overlaps of runs in equal rows
+	int intersection = 0;
+	int i = 0;
+	int j = 0;
+	while(i < a.row.size() && j < b.row.size()){
+
+		if(a.row[i] < b.row[j]){
+			i++;
+		}
+		else if(a.row[i] > b.row[j]){
+			j++;
+		}
+		else{
+			int begin = std::max(a.col_begin[i], b.col_begin[j]);
+			int end = std::min(a.col_end[i], b.col_end[j]);
+			if(end > begin)
+				intersection += end - begin;
+
+			// Advance the run which ends first
+			if(a.col_end[i] < b.col_end[j])
+				i++;
+			else
+				j++;
+		}
+	}
+
+	int area_union = getFootprintArea(a) + getFootprintArea(b) - intersection;
+	return (area_union > 0) ? float(intersection) / area_union : 0.0;
+}
+
 MatrixXf Tools::getImage2DBoundingBox(
 	const Point & point,
 	const float width,
@@ -218,3 +260,60 @@ MatrixXf Tools::transformVeloToImage(const MatrixXf & velo_points){
 
 	return transformRectCamToImage(TRANS_CAM_TO_RECTCAM * TRANS_VELO_TO_CAM * velo_points);
 }
+
+void Tools::writeKittiLine(std::ostream & stream, const int frame,
+	const Object & o, const Point & cam_point){
+
+	char line[KITTI_LINE_SIZE];
+	int length = formatKittiLine(line, KITTI_LINE_SIZE, frame, o, cam_point);
+	if(length > 0)
+		stream.write(line, length);
+}
+
+int Tools::formatKittiLine(char * buffer, const int size, const int frame,
+	const Object & o, const Point & cam_point){
+
+	KittiRecord record;
+	getKittiRecord(frame, o, cam_point, record);
+	return formatKittiLine(buffer, size, record);
+}
+
+void Tools::getKittiRecord(const int frame, const Object & o,
+	const Point & cam_point, KittiRecord & record){
+
+	// Image bounding box of the object
+	MatrixXf bounding_box = getImage2DBoundingBox(o);
+
+	record.x = cam_point.x;
+	record.y = cam_point.y;
+	record.z = cam_point.z;
+	record.left = bounding_box(0,0);
+	record.top = bounding_box(1,0);
+	record.right = bounding_box(0,1);
+	record.bottom = bounding_box(1,1);
+	record.height = o.height;
+	record.width = o.width;
+	record.length = o.length;
+	record.orientation = o.orientation;
+	record.confidence = o.semantic_confidence;
+	record.frame = frame;
+	record.id = o.id;
+	record.semantic_id = o.semantic_id;
+	std::memset(record.name, 0, sizeof(record.name));
+	std::strncpy(record.name, o.semantic_name.c_str(),
+		sizeof(record.name) - 1);
+}
+
+int Tools::formatKittiLine(char * buffer, const int size,
+	const KittiRecord & record){
+
+	// Shortest of fixed and scientific notation with 6 digits, as the
+	// default formatting of a stream
+	int length = std::snprintf(buffer, size, "%d %d %s 0 0 0 %g %g %g %g %g %g"
+		" %g %g %g %g %g %g\n", record.frame, record.id, record.name,
+		record.left, record.top, record.right, record.bottom,
+		record.height, record.width, record.length,
+		record.x, record.y, record.z,
+		record.orientation, record.confidence);
+	return (length < 0 || length >= size) ? -1 : length;
+}
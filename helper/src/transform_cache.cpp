@@ -0,0 +1,147 @@
+#include <helper/transform_cache.h>
+#include <boost/weak_ptr.hpp>
+#include <mutex>
+
+// Stamped transforms kept per cache
+static const int CACHE_SIZE = 8;
+
+TransformCache::TransformCache(
+	const boost::shared_ptr<tf::TransformListener> & listener):
+	listener_(listener),
+	entries_(CACHE_SIZE),
+	next_(0),
+	has_latest_(false),
+	lookups_(0),
+	hits_(0)
+	{
+}
+
+boost::shared_ptr<tf::TransformListener> TransformCache::sharedListener(){
+
+	static std::mutex mutex;
+	static boost::weak_ptr<tf::TransformListener> shared;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	boost::shared_ptr<tf::TransformListener> listener = shared.lock();
+	if(!listener){
+		listener.reset(new tf::TransformListener);
+		shared = listener;
+	}
+	return listener;
+}
+
+const Eigen::Matrix4d & TransformCache::lookup(const std::string & target_frame,
+	const std::string & source_frame, const ros::Time & stamp){
+
+	return find(target_frame, source_frame, stamp, false);
+}
+
+void TransformCache::transformPoint(const std::string & target_frame,
+	const geometry_msgs::PointStamped & in,
+	geometry_msgs::PointStamped & out){
+
+	const Eigen::Matrix4d & T = find(target_frame, in.header.frame_id,
+		in.header.stamp, false);
+	apply(T, in.point, out.point);
+	out.header.stamp = in.header.stamp;
+	out.header.frame_id = target_frame;
+}
+
+void TransformCache::transformObjects(helper::ObjectArray & objects,
+	geometry_msgs::PointStamped helper::Object::* source,
+	const std::string & target_frame,
+	geometry_msgs::PointStamped helper::Object::* target){
+
+	// The latest transform is looked up once for the whole list
+	has_latest_ = false;
+	const Eigen::Matrix4d * T = NULL;
+	const geometry_msgs::PointStamped * last = NULL;
+	for(int i = 0; i < objects.list.size(); ++i){
+
+		// Objects of one list usually share frame and stamp
+		const geometry_msgs::PointStamped & in = objects.list[i].*source;
+		if(!last || in.header.stamp != last->header.stamp ||
+			in.header.frame_id != last->header.frame_id)
+			T = &find(target_frame, in.header.frame_id, in.header.stamp,
+				true);
+		last = &in;
+
+		geometry_msgs::PointStamped & out = objects.list[i].*target;
+		apply(*T, in.point, out.point);
+		out.header.stamp = in.header.stamp;
+		out.header.frame_id = target_frame;
+	}
+	has_latest_ = false;
+}
+
+const Eigen::Matrix4d & TransformCache::find(const std::string & target_frame,
+	const std::string & source_frame, const ros::Time & stamp,
+	const bool keep_latest){
+
+	// Recent lookup of the same transform
+	bool latest = stamp.isZero();
+	Entry * entry = NULL;
+	if(latest){
+		if(keep_latest && has_latest_ &&
+			latest_.target_frame == target_frame &&
+			latest_.source_frame == source_frame){
+			hits_++;
+			return latest_.T;
+		}
+		entry = &latest_;
+	}
+	else{
+		for(int i = 0; i < entries_.size(); ++i){
+			Entry & e = entries_[i];
+			if(e.stamp == stamp && e.target_frame == target_frame &&
+				e.source_frame == source_frame){
+				hits_++;
+				return e.T;
+			}
+		}
+		entry = &entries_[next_];
+		next_ = (next_ + 1) % entries_.size();
+	}
+
+	// Interpolate the transform tree once, the entry stays invalid if it
+	// throws
+	entry->stamp = ros::Time();
+	entry->target_frame.clear();
+	tf::StampedTransform transform;
+	listener_->lookupTransform(target_frame, source_frame, stamp, transform);
+	lookups_++;
+
+	const tf::Matrix3x3 & basis = transform.getBasis();
+	const tf::Vector3 & origin = transform.getOrigin();
+	entry->T.setIdentity();
+	for(int r = 0; r < 3; ++r){
+		for(int c = 0; c < 3; ++c)
+			entry->T(r,c) = basis[r][c];
+		entry->T(r,3) = origin[r];
+	}
+	entry->target_frame = target_frame;
+	entry->source_frame = source_frame;
+	entry->stamp = stamp;
+	if(latest)
+		has_latest_ = keep_latest;
+	return entry->T;
+}
+
+void TransformCache::clear(){
+
+	for(int i = 0; i < entries_.size(); ++i){
+		entries_[i].stamp = ros::Time();
+		entries_[i].target_frame.clear();
+	}
+	has_latest_ = false;
+}
+
+int TransformCache::getLookups() const{
+
+	return lookups_;
+}
+
+int TransformCache::getHits() const{
+
+	return hits_;
+}
@@ -0,0 +1,66 @@
+// Include guard
+#ifndef association_H
+#define association_H
+
+// Includes
+#include <helper/assignment.h>
+#include <tracking_lib/thread_pool.h>
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+// Gated pair of track and detected object
+struct Candidate{
+
+	int track;
+	int object;
+	float cost;
+};
+
+/*
+ * Global minimum cost assignment of tracks and detected objects over a sparse
+ * set of gated candidates. Tracks and objects connected by candidates form
+ * independent components, which are solved in parallel. A track stays
+ * unassigned at its miss cost.
+ */
+class GatedAssignment{
+
+public:
+
+	// Default constructor
+	GatedAssignment();
+
+	// Virtual destructor
+	virtual ~GatedAssignment();
+
+	// Assign tracks and objects, unassigned entries are -1
+	void solve(const int num_tracks, const int num_objects,
+		const std::vector<Candidate> & candidates,
+		const std::vector<float> & miss_costs, ThreadPool & pool,
+		std::vector<int> & track_to_object,
+		std::vector<int> & object_to_track);
+
+	// Number of components of the last assignment
+	int getNumberOfComponents() const;
+
+private:
+
+	// Union find over tracks [0, num_tracks) and objects afterwards
+	std::vector<int> parent_;
+
+	// Candidate indices grouped by component
+	std::vector<int> component_begin_;
+	std::vector<int> component_candidates_;
+
+	int findRoot(int node);
+	void solveComponent(const int component,
+		const std::vector<Candidate> & candidates,
+		const std::vector<float> & miss_costs,
+		std::vector<int> & track_to_object,
+		std::vector<int> & object_to_track) const;
+};
+
+} // namespace tracking
+
+#endif // association_H
@@ -0,0 +1,62 @@
+// Include guard
+#ifndef imm_H
+#define imm_H
+
+// Includes
+#include <tracking_lib/ukf_filter.h>
+#include <tracking_lib/sigma_batch.h>
+
+// Namespaces
+namespace tracking{
+
+// State and probability of each motion model of a track
+struct ModelSet{
+
+	Filter::StateVector x[NUM_MODELS];
+	Filter::StateMatrix P[NUM_MODELS];
+	Filter::Innovation inn[NUM_MODELS];
+	double mu[NUM_MODELS];
+};
+
+/*
+ * Interacting multiple model estimator over the constant velocity and the
+ * CTRV model. The model states are mixed by a Markov transition before the
+ * prediction, reweighted by the measurement likelihood of each model after the
+ * update and combined into one estimate.
+ */
+class InteractingModels{
+
+public:
+
+	// Default constructor
+	InteractingModels();
+
+	// Virtual destructor
+	virtual ~InteractingModels();
+
+	// Probability to stay in a model between two frames
+	void init(const double p_stay);
+
+	// Mix the model states, mu becomes the predicted model probabilities
+	void mix(ModelSet & models) const;
+
+	// Model probabilities from the measurement likelihood of each model
+	void update(ModelSet & models, const double likelihood[NUM_MODELS]) const;
+
+	// Combined estimate of all models
+	void combine(const ModelSet & models, Filter::StateVector & x,
+		Filter::StateMatrix & P) const;
+
+private:
+
+	// Markov transition, row from and column to model
+	double transition_[NUM_MODELS][NUM_MODELS];
+
+	// Weighted moments of model states around a reference yaw
+	void merge(const ModelSet & models, const double weights[NUM_MODELS],
+		Filter::StateVector & x, Filter::StateMatrix & P) const;
+};
+
+} // namespace tracking
+
+#endif // imm_H
@@ -0,0 +1,183 @@
+// Include guard
+#ifndef parameter_H
+#define parameter_H
+
+// Includes
+#include <ros/console.h>
+#include <string>
+
+// Namespaces
+namespace tracking{
+
+struct Parameter{
+
+	float da_ped_dist_pos;
+	float da_ped_dist_form;
+	float da_car_dist_pos;
+	float da_car_dist_form;
+	bool da_mahalanobis;
+	float da_mahalanobis_gate;
+	float da_mahalanobis_std;
+
+	int tra_dim_z;
+	int tra_dim_x;
+	int tra_dim_x_aug;
+
+	float tra_std_lidar_x;
+	float tra_std_lidar_y;
+	float tra_std_acc;
+	float tra_std_yaw_rate;
+	float tra_lambda;
+	int tra_aging_bad;
+	bool tra_batch_prediction;
+	int tra_threads;
+	bool tra_linear_update;
+	bool tra_square_root;
+	bool tra_imm;
+	float tra_imm_p_stay;
+	float tra_imm_mu_cv;
+	int tra_history_depth;
+	int tra_trajectory_length;
+	bool tra_trajectory_publish;
+	bool tra_forecast_publish;
+	float tra_forecast_step;
+	int tra_forecast_steps;
+	bool tra_snapshot;
+	std::string tra_snapshot_file;
+	int tra_snapshot_interval;
+	float tra_snapshot_max_age;
+
+	float tra_occ_factor;
+
+	float p_init_x;
+	float p_init_y;
+	float p_init_v;
+	float p_init_yaw;
+	float p_init_yaw_rate;
+};
+
+// Read parameters from a source with the interface of ros::NodeHandle::param
+template<typename Source>
+void loadParameter(Source & source, Parameter & params){
+
+	source.param("data_association/ped/dist/position",
+		params.da_ped_dist_pos, params.da_ped_dist_pos);
+	source.param("data_association/ped/dist/form",
+		params.da_ped_dist_form, params.da_ped_dist_form);
+	source.param("data_association/car/dist/position",
+		params.da_car_dist_pos, params.da_car_dist_pos);
+	source.param("data_association/car/dist/form",
+		params.da_car_dist_form, params.da_car_dist_form);
+	source.param("data_association/mahalanobis/enabled",
+		params.da_mahalanobis, false);
+	source.param("data_association/mahalanobis/gate",
+		params.da_mahalanobis_gate, 9.21f);
+	source.param("data_association/mahalanobis/std",
+		params.da_mahalanobis_std, 1.0f);
+
+	source.param("tracking/dim/z", params.tra_dim_z,
+		params.tra_dim_z);
+	source.param("tracking/dim/x", params.tra_dim_x,
+		params.tra_dim_x);
+	source.param("tracking/dim/x_aug", params.tra_dim_x_aug,
+		params.tra_dim_x_aug);
+
+	source.param("tracking/std/lidar/x", params.tra_std_lidar_x,
+		params.tra_std_lidar_x);
+	source.param("tracking/std/lidar/y", params.tra_std_lidar_y,
+		params.tra_std_lidar_y);
+	source.param("tracking/std/acc", params.tra_std_acc,
+		params.tra_std_acc);
+	source.param("tracking/std/yaw_rate", params.tra_std_yaw_rate,
+		params.tra_std_yaw_rate);
+	source.param("tracking/lambda", params.tra_lambda,
+		params.tra_lambda);
+	source.param("tracking/aging/bad", params.tra_aging_bad,
+		params.tra_aging_bad);
+	source.param("tracking/batch_prediction",
+		params.tra_batch_prediction, true);
+	source.param("tracking/threads", params.tra_threads, 1);
+	source.param("tracking/linear_update", params.tra_linear_update,
+		true);
+	source.param("tracking/square_root", params.tra_square_root, false);
+	source.param("tracking/imm/enabled", params.tra_imm, false);
+	source.param("tracking/imm/p_stay", params.tra_imm_p_stay, 0.95f);
+	source.param("tracking/imm/mu_cv", params.tra_imm_mu_cv, 0.5f);
+	source.param("tracking/history/depth", params.tra_history_depth, 0);
+	source.param("tracking/trajectory/length", params.tra_trajectory_length,
+		20);
+	source.param("tracking/trajectory/publish",
+		params.tra_trajectory_publish, false);
+	source.param("tracking/forecast/publish", params.tra_forecast_publish,
+		false);
+	source.param("tracking/forecast/step", params.tra_forecast_step, 0.3f);
+	source.param("tracking/forecast/steps", params.tra_forecast_steps, 10);
+	source.param("tracking/snapshot/enabled", params.tra_snapshot, false);
+	source.param("tracking/snapshot/file", params.tra_snapshot_file,
+		std::string("/tmp/tracking_snapshot.bin"));
+	source.param("tracking/snapshot/interval", params.tra_snapshot_interval,
+		10);
+	source.param("tracking/snapshot/max_age", params.tra_snapshot_max_age,
+		1.0f);
+	source.param("tracking/occlusion_factor", params.tra_occ_factor, 
+		params.tra_occ_factor);
+	source.param("track/P_init/x", params.p_init_x,
+		params.p_init_x);
+	source.param("track/P_init/y", params.p_init_y,
+		params.p_init_y);
+	source.param("track/P_init/v", params.p_init_v,
+		params.p_init_v);
+	source.param("track/P_init/yaw", params.p_init_yaw,
+		params.p_init_yaw);
+	source.param("track/P_init/yaw_rate", params.p_init_yaw_rate, 
+		params.p_init_yaw_rate);
+}
+
+// Print parameters
+inline void printParameter(const Parameter & params){
+
+	ROS_INFO_STREAM("da_ped_dist_pos " << params.da_ped_dist_pos);
+	ROS_INFO_STREAM("da_ped_dist_form " << params.da_ped_dist_form);
+	ROS_INFO_STREAM("da_car_dist_pos " << params.da_car_dist_pos);
+	ROS_INFO_STREAM("da_car_dist_form " << params.da_car_dist_form);
+	ROS_INFO_STREAM("da_mahalanobis " << params.da_mahalanobis);
+	ROS_INFO_STREAM("da_mahalanobis_gate " << params.da_mahalanobis_gate);
+	ROS_INFO_STREAM("da_mahalanobis_std " << params.da_mahalanobis_std);
+	ROS_INFO_STREAM("tra_dim_z " << params.tra_dim_z);
+	ROS_INFO_STREAM("tra_dim_x " << params.tra_dim_x);
+	ROS_INFO_STREAM("tra_dim_x_aug " << params.tra_dim_x_aug);
+	ROS_INFO_STREAM("tra_std_lidar_x " << params.tra_std_lidar_x);
+	ROS_INFO_STREAM("tra_std_lidar_y " << params.tra_std_lidar_y);
+	ROS_INFO_STREAM("tra_std_acc " << params.tra_std_acc);
+	ROS_INFO_STREAM("tra_std_yaw_rate " << params.tra_std_yaw_rate);
+	ROS_INFO_STREAM("tra_lambda " << params.tra_lambda);
+	ROS_INFO_STREAM("tra_aging_bad " << params.tra_aging_bad);
+	ROS_INFO_STREAM("tra_batch_prediction " << params.tra_batch_prediction);
+	ROS_INFO_STREAM("tra_threads " << params.tra_threads);
+	ROS_INFO_STREAM("tra_linear_update " << params.tra_linear_update);
+	ROS_INFO_STREAM("tra_square_root " << params.tra_square_root);
+	ROS_INFO_STREAM("tra_imm " << params.tra_imm);
+	ROS_INFO_STREAM("tra_imm_p_stay " << params.tra_imm_p_stay);
+	ROS_INFO_STREAM("tra_imm_mu_cv " << params.tra_imm_mu_cv);
+	ROS_INFO_STREAM("tra_history_depth " << params.tra_history_depth);
+	ROS_INFO_STREAM("tra_trajectory_length " << params.tra_trajectory_length);
+	ROS_INFO_STREAM("tra_trajectory_publish " <<
+		params.tra_trajectory_publish);
+	ROS_INFO_STREAM("tra_forecast_publish " << params.tra_forecast_publish);
+	ROS_INFO_STREAM("tra_forecast_step " << params.tra_forecast_step);
+	ROS_INFO_STREAM("tra_forecast_steps " << params.tra_forecast_steps);
+	ROS_INFO_STREAM("tra_snapshot " << params.tra_snapshot);
+	ROS_INFO_STREAM("tra_snapshot_file " << params.tra_snapshot_file);
+	ROS_INFO_STREAM("tra_snapshot_interval " << params.tra_snapshot_interval);
+	ROS_INFO_STREAM("tra_snapshot_max_age " << params.tra_snapshot_max_age);
+	ROS_INFO_STREAM("tra_occ_factor " << params.tra_occ_factor);
+	ROS_INFO_STREAM("p_init_x " << params.p_init_x);
+	ROS_INFO_STREAM("p_init_y " << params.p_init_y);
+	ROS_INFO_STREAM("p_init_v " << params.p_init_v);
+	ROS_INFO_STREAM("p_init_yaw " << params.p_init_yaw);
+	ROS_INFO_STREAM("p_init_yaw_rate " << params.p_init_yaw_rate);
+}
+
+} // namespace tracking
+
+#endif // parameter_H
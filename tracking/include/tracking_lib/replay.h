@@ -0,0 +1,58 @@
+// Include guard
+#ifndef replay_H
+#define replay_H
+
+// Includes
+#include <tracking_lib/tracker.h>
+#include <helper/tools.h>
+#include <helper/kitti_record.h>
+#include <tf2/buffer_core.h>
+#include <boost/shared_ptr.hpp>
+#include <ostream>
+
+// Namespaces
+namespace tracking{
+
+/*
+ * Recorded sequence of detected object lists and transforms from a bag, run
+ * through a tracker as fast as possible without a ROS master.
+ */
+class SequenceReplay{
+
+public:
+
+	// Default constructor
+	SequenceReplay();
+
+	// Virtual destructor
+	virtual ~SequenceReplay();
+
+	// Read /detection/objects, /tf and /tf_static of a bag, false on error
+	bool open(const std::string & filename);
+
+	// Track all frames and write KITTI tracking results, returns the number
+	// of written tracks. The records of the written tracks are appended in
+	// frame order if given.
+	int run(const Parameter & params, std::ostream & results,
+		std::vector<KittiRecord> * records = NULL);
+
+	// Number of frames
+	int size() const;
+
+private:
+
+	// Recorded frames and transforms
+	std::vector<ObjectArray> frames_;
+	boost::shared_ptr<tf2::BufferCore> transforms_;
+
+	// KITTI output
+	Tools tools_;
+
+	bool transformPoint(const std::string & target_frame,
+		const geometry_msgs::PointStamped & in,
+		geometry_msgs::PointStamped & out) const;
+};
+
+} // namespace tracking
+
+#endif // replay_H
@@ -0,0 +1,99 @@
+// Include guard
+#ifndef sigma_batch_H
+#define sigma_batch_H
+
+// Includes
+#include <tracking_lib/ukf_filter.h>
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+// Motion models of the batch, constant velocity keeps the yaw rate at zero
+enum MotionModel{ MODEL_CV = 0, MODEL_CTRV = 1, NUM_MODELS = 2 };
+
+/*
+ * Batched CTRV prediction of the sigma points of many states. Every state
+ * component is stored as one contiguous array over all entries and sigma
+ * points (structure of arrays), so the motion model runs as one vector kernel
+ * and mean and covariance are blocked weighted reductions over all entries.
+ */
+class SigmaPointBatch{
+
+public:
+
+	// Default constructor
+	SigmaPointBatch();
+
+	// Virtual destructor
+	virtual ~SigmaPointBatch();
+
+	// Take dimensions, weights and noise of the filter and remove all entries
+	void init(const Filter & filter);
+	void clear();
+
+	// Generate the augmented sigma points of a state, returns its entry.
+	// Constant velocity entries added before any CTRV entry skip the turning
+	// part of the motion model.
+	int add(const Filter::StateVector & x, const Filter::StateMatrix & P,
+		const MotionModel model = MODEL_CTRV);
+
+	// Propagate all sigma points with the CTRV motion model, which is the
+	// constant velocity model for entries without yaw rate
+	void predict(const double delta_t);
+
+	// Continue from the predicted sigma points with the same noise samples,
+	// so that further predictions extend the same motion
+	void advance();
+
+	// Weighted mean and covariance of all predicted entries
+	void computeMoments();
+
+	// Weighted mean only, for predictions without a covariance
+	void computeMean();
+
+	// Getter
+	int size() const;
+	void getSigmaPoints(const int k, Filter::SigmaMatrix & Xsig_pred) const;
+	void getState(const int k, Filter::StateVector & x,
+		Filter::StateMatrix & P) const;
+	void getMean(const int k, Filter::StateVector & x) const;
+	void getPositionCovariance(const int k, Matrix2d & P) const;
+
+private:
+
+	// Filter parameters
+	int dim_x_;
+	int dim_x_aug_;
+	int dim_sig_;
+	double spread_;
+	double std_acc_;
+	double std_yaw_rate_;
+	VectorXd weights_;
+
+	// Number of entries, leading constant velocity entries and allocated
+	// entries
+	int size_;
+	int straight_;
+	int capacity_;
+
+	// Augmented and predicted sigma points, index k * dim_sig + j
+	std::vector<ArrayXd> aug_;
+	std::vector<ArrayXd> pred_;
+
+	// Sine and cosine of yaw before and after prediction
+	std::vector<ArrayXd> trig_;
+
+	// Mean and upper triangle of covariance per entry
+	std::vector<ArrayXd> mean_;
+	std::vector<ArrayXd> cov_;
+
+	// Deviations of a block of entries
+	std::vector<MatrixXd> diff_;
+
+	void reserve(const int capacity);
+};
+
+} // namespace tracking
+
+#endif // sigma_batch_H
@@ -0,0 +1,45 @@
+// Include guard
+#ifndef sigma_kernel_H
+#define sigma_kernel_H
+
+// Namespaces
+namespace tracking{
+
+// Component arrays of the sigma points, one value per entry and sigma point
+struct SigmaKernelArrays{
+
+	// Augmented sigma points
+	const double * p_x;
+	const double * p_y;
+	const double * v;
+	const double * yaw;
+	const double * yawd;
+	const double * nu_a;
+	const double * nu_yawdd;
+
+	// Predicted sigma points
+	double * px_p;
+	double * py_p;
+	double * v_p;
+	double * yaw_p;
+	double * yawd_p;
+
+	// Sine and cosine of the yaw before and after the prediction
+	double * sin_yaw;
+	double * cos_yaw;
+	double * sin_yaw_t;
+	double * cos_yaw_t;
+};
+
+/*
+ * CTRV prediction of n sigma points, the first n_straight of them with
+ * constant velocity. This is the only code built with relaxed floating point
+ * for vector sine and cosine, so it must not use inline or template code that
+ * other translation units instantiate as well.
+ */
+void predictSigmaPoints(const SigmaKernelArrays & arrays, const int n,
+	const int n_straight, const double delta_t);
+
+} // namespace tracking
+
+#endif // sigma_kernel_H
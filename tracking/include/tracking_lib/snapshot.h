@@ -0,0 +1,150 @@
+// Include guard
+#ifndef snapshot_H
+#define snapshot_H
+
+// Includes
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+// Appends plain values to a binary buffer
+class BinaryWriter{
+
+public:
+
+	// Constructor
+	explicit BinaryWriter(std::vector<char> & buffer):
+		buffer_(buffer){
+	}
+
+	template<typename T>
+	void put(const T & value){
+		putBytes(&value, sizeof(T));
+	}
+
+	void putArray(const double * data, const int n){
+		putBytes(data, n * sizeof(double));
+	}
+
+	void putString(const std::string & s){
+		put(int(s.size()));
+		putBytes(s.data(), s.size());
+	}
+
+private:
+
+	std::vector<char> & buffer_;
+
+	void putBytes(const void * data, const size_t n){
+		size_t offset = buffer_.size();
+		buffer_.resize(offset + n);
+		if(n > 0)
+			std::memcpy(&buffer_[offset], data, n);
+	}
+};
+
+// Reads plain values back from a binary buffer, fails instead of reading
+// past its end
+class BinaryReader{
+
+public:
+
+	// Constructor
+	explicit BinaryReader(const std::vector<char> & buffer):
+		buffer_(buffer),
+		offset_(0){
+	}
+
+	template<typename T>
+	bool get(T & value){
+		return getBytes(&value, sizeof(T));
+	}
+
+	bool getArray(double * data, const int n){
+		return n >= 0 && getBytes(data, n * sizeof(double));
+	}
+
+	bool getString(std::string & s){
+		int n;
+		if(!get(n) || n < 0 || offset_ + n > buffer_.size())
+			return false;
+		s.assign(buffer_.data() + offset_, n);
+		offset_ += n;
+		return true;
+	}
+
+	// All bytes read
+	bool done() const{
+		return offset_ == buffer_.size();
+	}
+
+private:
+
+	const std::vector<char> & buffer_;
+	size_t offset_;
+
+	bool getBytes(void * data, const size_t n){
+		if(offset_ + n > buffer_.size())
+			return false;
+		if(n > 0)
+			std::memcpy(data, buffer_.data() + offset_, n);
+		offset_ += n;
+		return true;
+	}
+};
+
+/*
+ * Writes tracker snapshots to a file on a background thread. A snapshot is
+ * written to a temporary file and renamed, so the file always holds a complete
+ * snapshot. While one is being written a newer one replaces the waiting one.
+ */
+class SnapshotWriter{
+
+public:
+
+	// Default constructor
+	SnapshotWriter();
+
+	// Virtual destructor, writes the waiting snapshot
+	virtual ~SnapshotWriter();
+
+	// Start the writer thread for a file
+	void start(const std::string & filename);
+
+	// Write the waiting snapshot and join the writer thread
+	void stop();
+
+	// Hand over a snapshot, the buffer is swapped with a recycled one
+	void write(std::vector<char> & buffer);
+
+	// Read a snapshot file, false if it does not exist
+	static bool read(const std::string & filename, std::vector<char> & buffer);
+
+private:
+
+	// Target file
+	std::string filename_;
+
+	// Writer thread
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	bool running_;
+	bool stop_;
+
+	// Waiting snapshot
+	std::vector<char> pending_;
+	bool has_pending_;
+
+	void run();
+};
+
+} // namespace tracking
+
+#endif // snapshot_H
@@ -0,0 +1,68 @@
+// Include guard
+#ifndef spatial_hash_H
+#define spatial_hash_H
+
+// Includes
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+/*
+ * Uniform grid over 2D points hashed into a power of two number of buckets.
+ * Points are sorted by bucket in one counting sort pass, so building is linear
+ * in the number of points and a query only visits the cells around it.
+ */
+class SpatialHash{
+
+public:
+
+	// Default constructor
+	SpatialHash();
+
+	// Virtual destructor
+	virtual ~SpatialHash();
+
+	// Remove all points and set the cell size
+	void clear(const float cell_size);
+
+	// Add point with an index returned by queries
+	void add(const float x, const float y, const int index);
+
+	// Sort points into buckets, call after adding all points
+	void build();
+
+	// Indices of all points with |dx| <= radius and |dy| <= radius, in order
+	// of insertion per cell
+	void query(const float x, const float y, const float radius,
+		std::vector<int> & indices) const;
+
+	// Number of points
+	int size() const;
+
+private:
+
+	struct Entry{
+
+		int cell_x;
+		int cell_y;
+		float x;
+		float y;
+		int index;
+	};
+
+	float cell_size_;
+	unsigned int mask_;
+
+	// Points in insertion order and sorted by bucket
+	std::vector<Entry> points_;
+	std::vector<Entry> sorted_;
+	std::vector<int> bucket_begin_;
+
+	int toCell(const float value) const;
+	unsigned int toBucket(const int cell_x, const int cell_y) const;
+};
+
+} // namespace tracking
+
+#endif // spatial_hash_H
@@ -0,0 +1,63 @@
+// Include guard
+#ifndef thread_pool_H
+#define thread_pool_H
+
+// Includes
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+/*
+ * Fixed set of worker threads which split an index range into one contiguous
+ * shard per worker. Shards only depend on the range, the grain and the number
+ * of workers, so every run assigns the same indices to the same worker.
+ */
+class ThreadPool{
+
+public:
+
+	// Function of a shard with worker index and index range [begin, end)
+	typedef std::function<void(const int, const int, const int)> Task;
+
+	// Default constructor
+	ThreadPool();
+
+	// Virtual destructor
+	virtual ~ThreadPool();
+
+	// Start workers, the calling thread is worker 0
+	void init(const int num_threads);
+
+	// Number of workers including the calling thread
+	int size() const;
+
+	// Run task on shards of [0, n) with a multiple of grain indices per shard
+	void parallelFor(const int n, const int grain, const Task & task);
+
+private:
+
+	// Workers
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable start_;
+	std::condition_variable done_;
+
+	// Current task
+	const Task * task_;
+	int n_;
+	int chunk_;
+	int generation_;
+	int pending_;
+	bool stop_;
+
+	void run(const int worker);
+};
+
+} // namespace tracking
+
+#endif // thread_pool_H
@@ -0,0 +1,127 @@
+// Include guard
+#ifndef track_pool_H
+#define track_pool_H
+
+// Includes
+#include <Eigen/StdDeque>
+#include <deque>
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+// Reference to a slot, stale once the slot is erased and reused
+struct SlotHandle{
+
+	int index;
+	int generation;
+};
+
+/*
+ * Slot map of elements with stable handles. Elements stay in their slot from
+ * insertion to erasure, erased slots are reused in place by later insertions.
+ * Active slots are listed densely, so loops over [0, size()) visit all
+ * elements. Slots are stored in a deque, which grows by whole blocks, so
+ * inserting or erasing never moves an element and pointers from find() or
+ * operator[] stay valid until their element is erased.
+ */
+template<typename T>
+class SlotPool{
+
+public:
+
+	// Default constructor
+	SlotPool(){}
+
+	// Virtual destructor
+	virtual ~SlotPool(){}
+
+	// Number of active elements
+	int size() const { return active_.size(); }
+	bool empty() const { return active_.empty(); }
+
+	// Active element at dense position i
+	T & operator[](const int i) { return slots_[active_[i]]; }
+	const T & operator[](const int i) const { return slots_[active_[i]]; }
+
+	// Handle of active element at dense position i
+	SlotHandle handle(const int i) const {
+		SlotHandle h;
+		h.index = active_[i];
+		h.generation = generations_[active_[i]];
+		return h;
+	}
+
+	// Whether the handle still refers to its element
+	bool valid(const SlotHandle & h) const {
+		return h.index >= 0 && h.index < slots_.size() &&
+			generations_[h.index] == h.generation && position_[h.index] >= 0;
+	}
+
+	// Element of a handle, NULL if stale, valid until the element is erased
+	T * find(const SlotHandle & h) {
+		return valid(h) ? &slots_[h.index] : NULL;
+	}
+
+	// Insert element into a free slot, appended to the dense list
+	SlotHandle insert(const T & value){
+
+		int index;
+		if(free_.empty()){
+			index = slots_.size();
+			slots_.push_back(value);
+			generations_.push_back(0);
+			position_.push_back(-1);
+		}
+		else{
+			index = free_.back();
+			free_.pop_back();
+			slots_[index] = value;
+		}
+		position_[index] = active_.size();
+		active_.push_back(index);
+		return handle(active_.size() - 1);
+	}
+
+	// Erase element at dense position i, the last active element takes its
+	// position in the dense list
+	void erase(const int i){
+
+		int index = active_[i];
+		active_[i] = active_.back();
+		position_[active_[i]] = i;
+		active_.pop_back();
+		position_[index] = -1;
+		generations_[index]++;
+		free_.push_back(index);
+	}
+
+	// Erase element of a valid handle
+	void erase(const SlotHandle & h){
+
+		if(valid(h))
+			erase(position_[h.index]);
+	}
+
+	// Erase all elements, keeping the slots for reuse
+	void clear(){
+
+		for(int i = size() - 1; i >= 0; --i)
+			erase(i);
+	}
+
+private:
+
+	// Slots with generation and dense position, -1 if free
+	std::deque<T, Eigen::aligned_allocator<T> > slots_;
+	std::vector<int> generations_;
+	std::vector<int> position_;
+
+	// Free and active slot indices
+	std::vector<int> free_;
+	std::vector<int> active_;
+};
+
+} // namespace tracking
+
+#endif // track_pool_H
@@ -0,0 +1,255 @@
+// Include guard
+#ifndef tracker_H
+#define tracker_H
+
+// Includes
+#include <helper/ObjectArray.h>
+#include <helper/TrajectoryArray.h>
+#include <helper/ForecastArray.h>
+#include <Eigen/Dense>
+#include <opencv2/core/core.hpp>
+#include <tracking_lib/parameter.h>
+#include <tracking_lib/ukf_filter.h>
+#include <tracking_lib/sigma_batch.h>
+#include <tracking_lib/thread_pool.h>
+#include <tracking_lib/association.h>
+#include <tracking_lib/spatial_hash.h>
+#include <tracking_lib/track_pool.h>
+#include <tracking_lib/imm.h>
+#include <tracking_lib/snapshot.h>
+#include <tracking_lib/trajectory.h>
+
+// Namespaces
+namespace tracking{
+
+using namespace helper;
+using namespace Eigen;
+
+struct History{
+
+	int good_age;
+	int bad_age;
+
+};
+
+struct Geometry{
+
+	float width;
+	float length;
+	float height;
+	float orientation;
+};
+
+struct Semantic{
+
+	int id;
+	std::string name;
+	float confidence;
+};
+
+struct State{
+
+	Filter::StateVector x;
+	float z;
+	Filter::StateMatrix P;
+	Filter::StateMatrix L;
+	Filter::SigmaMatrix Xsig_pred;
+	Filter::Innovation inn;
+
+	// Innovation covariance widened for the Mahalanobis gate and its inverse
+	Filter::MeasurementMatrix gate_S;
+	Filter::MeasurementMatrix gate_S_inv;
+};
+
+struct Track{
+
+	// Attributes
+	int id;
+	State sta;
+	ModelSet models;
+	Geometry geo;
+	Semantic sem;
+	History hist;
+	int r;
+	int g;
+	int b;
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+// Tracks in stable slots, iterated densely
+typedef SlotPool<Track> TrackPool;
+
+// Tracker state before a frame
+struct Checkpoint{
+
+	TrackPool tracks;
+	TrajectoryStore trajectories;
+	int track_id_counter;
+	uint64_t rng_state;
+	double time_stamp;
+	bool is_initialized;
+};
+
+// Recorded frame with the tracker state before it
+struct FrameRecord{
+
+	Checkpoint before;
+	ObjectArray frame;
+};
+
+// Accumulated run time of the processing stages in ms
+struct StageTimes{
+
+	int frames;
+	double prediction;
+	double association;
+	double update;
+	double management;
+	double forecast;
+};
+
+// Out of sequence frames, rollback depth in frames and replay time in ms
+struct ReplayStatistics{
+
+	int late_frames;
+	int dropped_frames;
+	int last_depth;
+	int max_depth;
+	double last_time;
+	double total_time;
+};
+
+/*
+ * Multi object tracker on detected object lists in world coordinates. Holds
+ * all tracks, runs prediction, data association, update and track management
+ * per frame and does not depend on a running ROS node.
+ */
+class Tracker{
+
+public:
+
+	// Default constructor
+	Tracker();
+
+	// Virtual destructor
+	virtual ~Tracker();
+
+	// Set parameters and remove all tracks
+	void init(const Parameter & params);
+
+	// Process one frame of detected objects. A frame older than the last one
+	// rolls the tracker back to the recorded state before it and replays all
+	// later recorded frames.
+	void process(const ObjectArray & detected_objects);
+
+	// Tracks as object list in world coordinates
+	void getTrackList(ObjectArray & track_list) const;
+
+	// Recent states of all tracks in the order of the track list
+	void getTrajectoryList(TrajectoryArray & trajectory_list) const;
+
+	// Tracks as object list in world coordinates, predicted to a time stamp
+	// by the motion model without changing the tracks
+	void predictTrackList(const double time_stamp, ObjectArray & track_list);
+
+	// Forecasts of all tracks in the order of the track list at the
+	// configured horizons, with the position covariance as ellipse
+	void getForecastList(ForecastArray & forecast_list);
+
+	// Binary snapshot of all tracks, the id counter and the last time stamp
+	void saveState(std::vector<char> & buffer) const;
+
+	// Continue from a snapshot taken at most max_age seconds before the
+	// time stamp, false if it is too old or does not fit the filter
+	bool restoreState(const std::vector<char> & buffer,
+		const double time_stamp, const double max_age);
+
+	// Getter
+	bool isInitialized() const;
+	double getTimeStamp() const;
+	const ReplayStatistics & getReplayStatistics() const;
+	const StageTimes & getStageTimes() const;
+	void resetStageTimes();
+	const Parameter & getParameter() const;
+	const TrackPool & getTracks() const;
+
+	// Trajectory of track i is in slot getTracks().handle(i).index
+	const TrajectoryStore & getTrajectories() const;
+
+	void printTrack(const Track & tr) const;
+	void printTracks() const;
+
+protected:
+
+	// Class member
+	Parameter params_;
+
+private:
+
+	// Processing
+	bool is_initialized_;
+	int track_id_counter_;
+
+	// Visualization
+	cv::RNG rng_;
+
+	// UKF
+	Filter filter_;
+	InteractingModels imm_;
+	std::vector<SigmaPointBatch> batches_;
+	SigmaPointBatch query_batch_;
+	TrackPool tracks_;
+	TrajectoryStore trajectories_;
+
+	// Parallel execution
+	ThreadPool pool_;
+
+	// Prediction
+	double last_time_stamp_;
+
+	// Ring buffer of recent frames for out of sequence frames, ordered by
+	// time stamp, and the time stamp of the last frame that dropped out
+	std::vector<FrameRecord> history_;
+	int history_begin_;
+	int history_size_;
+	double evicted_time_stamp_;
+	std::vector<ObjectArray> replay_frames_;
+	ReplayStatistics replay_stats_;
+
+	// Profiling
+	StageTimes stage_times_;
+
+	// Class functions
+	void processFrame(const ObjectArray & detected_objects);
+	void processLate(const ObjectArray & detected_objects);
+	void recordFrame(const ObjectArray & detected_objects);
+	FrameRecord & recordAt(const int k);
+	void saveCheckpoint(Checkpoint & checkpoint) const;
+	void restoreCheckpoint(const Checkpoint & checkpoint);
+	void recordTrajectories(const double time_stamp);
+	void Prediction(const double delta_t);
+	void PredictMeasurements();
+	void Update(const ObjectArray & detected_objects);
+	void TrackManagement(const ObjectArray & detected_objects);
+	void initTrack(const Object & obj);
+
+	// Data Association members
+	std::vector<int> da_tracks;
+	std::vector<int> da_objects;
+	GatedAssignment assignment_;
+	SpatialHash ped_index_;
+	SpatialHash car_index_;
+	std::vector<int> gate_indices_;
+
+	// Data Association functions
+	void GlobalNearestNeighbor(const ObjectArray & detected_objects);
+	float CalculateDistance(const Track & track, const Object & object);
+	float CalculateBoxMismatch(const Track & track, const Object & object);
+	float CalculateEuclideanAndBoxOffset(const Track & track, 
+		const Object & object);
+};
+
+} // namespace tracking
+
+#endif // tracker_H
@@ -0,0 +1,68 @@
+// Include guard
+#ifndef trajectory_H
+#define trajectory_H
+
+// Includes
+#include <vector>
+
+// Namespaces
+namespace tracking{
+
+// Track state at one frame
+struct TrajectoryPoint{
+
+	double stamp;
+	float x;
+	float y;
+	float v;
+	float yaw;
+};
+
+/*
+ * Recent states of all tracks in one contiguous array, a ring buffer of fixed
+ * length per track pool slot. A slot starts an empty trajectory when a new
+ * track takes it, so storage only grows with the number of slots.
+ */
+class TrajectoryStore{
+
+public:
+
+	// Default constructor
+	TrajectoryStore();
+
+	// Virtual destructor
+	virtual ~TrajectoryStore();
+
+	// Set the number of points per trajectory and remove all trajectories
+	void init(const int length);
+
+	// Provide storage for slots [0, num_slots)
+	void reserve(const int num_slots);
+
+	// Start an empty trajectory in a slot
+	void reset(const int slot);
+
+	// Append a point, the oldest one is overwritten once the ring is full
+	void push(const int slot, const TrajectoryPoint & point);
+
+	// Number of points of a slot and point k, from oldest 0 to newest
+	int size(const int slot) const;
+	const TrajectoryPoint & at(const int slot, const int k) const;
+
+	// Points per trajectory
+	int length() const;
+
+private:
+
+	int length_;
+
+	// Points of slot s at [s * length, (s + 1) * length), index of the oldest
+	// point and number of points per slot
+	std::vector<TrajectoryPoint> points_;
+	std::vector<int> begin_;
+	std::vector<int> size_;
+};
+
+} // namespace tracking
+
+#endif // trajectory_H
@@ -0,0 +1,547 @@
+// Include guard
+#ifndef ukf_filter_H
+#define ukf_filter_H
+
+// Includes
+#include <Eigen/Dense>
+#include <cmath>
+
+// Namespaces
+namespace tracking{
+
+using namespace Eigen;
+
+// Number of sigma points of an augmented state dimension
+template<int NXA>
+struct SigmaPoints{
+
+	enum { value = (NXA == Dynamic) ? int(Dynamic) : 2 * NXA + 1 };
+};
+
+/*
+ * Unscented Kalman filter with the CTRV motion model [x, y, v, yaw, yaw_rate]
+ * augmented by longitudinal and yaw acceleration noise and a lidar position
+ * measurement [x, y]. With fixed dimensions all matrices live on the stack,
+ * Dynamic dimensions are set at runtime.
+ */
+template<int NX, int NXA, int NZ>
+class UnscentedFilter{
+
+public:
+
+	// Dimensions
+	enum { DimX = NX, DimXAug = NXA, DimZ = NZ,
+		DimSig = SigmaPoints<NXA>::value };
+
+	// Types
+	typedef Matrix<double, NX, 1> StateVector;
+	typedef Matrix<double, NX, NX> StateMatrix;
+	typedef Matrix<double, NXA, 1> AugStateVector;
+	typedef Matrix<double, NXA, NXA> AugStateMatrix;
+	typedef Matrix<double, NXA, DimSig> AugSigmaMatrix;
+	typedef Matrix<double, NX, DimSig> SigmaMatrix;
+	typedef Matrix<double, NZ, 1> MeasurementVector;
+	typedef Matrix<double, NZ, NZ> MeasurementMatrix;
+	typedef Matrix<double, NZ, DimSig> MeasurementSigmaMatrix;
+	typedef Matrix<double, NX, NZ> GainMatrix;
+	typedef Matrix<double, DimSig, 1> WeightVector;
+
+	// Predicted measurement of a state with innovation covariance S, its
+	// inverse and the cross covariance Tc of state and measurement
+	struct Innovation{
+
+		MeasurementVector z_pred;
+		MeasurementMatrix S;
+		MeasurementMatrix S_inv;
+		GainMatrix Tc;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	// Default constructor
+	UnscentedFilter();
+
+	// Set dimensions, noise and spreading parameter
+	void init(const int dim_x, const int dim_x_aug, const int dim_z,
+		const double lambda, const double std_acc, const double std_yaw_rate,
+		const double std_lidar_x, const double std_lidar_y);
+
+	// Filter steps
+	void predict(StateVector & x, StateMatrix & P, SigmaMatrix & Xsig_pred,
+		const double delta_t) const;
+	void update(StateVector & x, StateMatrix & P, const SigmaMatrix & Xsig_pred,
+		const MeasurementVector & z) const;
+
+	// Kalman update for the measurement of the first state components, equal
+	// to the unscented update for this linear measurement, returns the
+	// likelihood of the measurement
+	double updateLinear(StateVector & x, StateMatrix & P,
+		const MeasurementVector & z) const;
+
+	// Square root filter steps on the lower Cholesky factor L of P
+	void predictSqrt(StateVector & x, StateMatrix & L, SigmaMatrix & Xsig_pred,
+		const double delta_t) const;
+	void updateSqrt(StateVector & x, StateMatrix & L,
+		const MeasurementVector & z) const;
+
+	// Innovation of a predicted state, once per frame for gating and update.
+	// From the sigma points for the unscented update, from the covariance for
+	// the linear one.
+	void predictMeasurement(const StateVector & x, const StateMatrix & P,
+		const SigmaMatrix & Xsig_pred, Innovation & inn) const;
+	void predictMeasurement(const StateVector & x, const StateMatrix & P,
+		Innovation & inn) const;
+
+	// Inverse of an innovation covariance, closed form for two dimensions
+	MeasurementMatrix invertInnovation(const MeasurementMatrix & S) const;
+
+	// Squared Mahalanobis distance of a measurement
+	double mahalanobis(const Innovation & inn,
+		const MeasurementVector & z) const;
+
+	// Update with a precomputed innovation, returns the likelihood of the
+	// measurement
+	double update(StateVector & x, StateMatrix & P, const Innovation & inn,
+		const MeasurementVector & z) const;
+	void updateSqrt(StateVector & x, StateMatrix & L, const Innovation & inn,
+		const MeasurementVector & z) const;
+
+	// Getter
+	int dimX() const { return dim_x_; }
+	int dimXAug() const { return dim_x_aug_; }
+	int dimZ() const { return dim_z_; }
+	int dimSig() const { return dim_sig_; }
+	double lambda() const { return lambda_; }
+	double stdAcc() const { return std_acc_; }
+	double stdYawRate() const { return std_yaw_rate_; }
+	const WeightVector & weights() const { return weights_; }
+
+	// Angle normalization to [-pi, pi]
+	static double normalizeAngle(double angle);
+
+	// Rank one update (sign 1) or downdate (sign -1) of L to the factor of
+	// L * L^T + sign * v * v^T, false if the result is not positive definite
+	static bool cholUpdate(StateMatrix & L, StateVector v, const double sign);
+
+private:
+
+	// Dimensions
+	int dim_x_;
+	int dim_x_aug_;
+	int dim_z_;
+	int dim_sig_;
+
+	// Parameters
+	double lambda_;
+	double std_acc_;
+	double std_yaw_rate_;
+
+	// Weights and measurement covariance
+	WeightVector weights_;
+	MeasurementMatrix R_;
+
+	// Sigma points of the augmented state
+	void generateSigmaPoints(const StateVector & x, const AugStateMatrix & L,
+		AugSigmaMatrix & Xsig_aug) const;
+	void predictSigmaPoints(const AugSigmaMatrix & Xsig_aug,
+		SigmaMatrix & Xsig_pred, const double delta_t) const;
+};
+
+/******************************************************************************/
+
+template<int NX, int NXA, int NZ>
+UnscentedFilter<NX, NXA, NZ>::UnscentedFilter():
+	dim_x_(NX),
+	dim_x_aug_(NXA),
+	dim_z_(NZ),
+	dim_sig_(DimSig),
+	lambda_(0.0),
+	std_acc_(0.0),
+	std_yaw_rate_(0.0)
+	{
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::init(const int dim_x, const int dim_x_aug,
+	const int dim_z, const double lambda, const double std_acc,
+	const double std_yaw_rate, const double std_lidar_x,
+	const double std_lidar_y){
+
+	// Dimensions
+	dim_x_ = dim_x;
+	dim_x_aug_ = dim_x_aug;
+	dim_z_ = dim_z;
+	dim_sig_ = 2 * dim_x_aug + 1;
+
+	// Parameters
+	lambda_ = lambda;
+	std_acc_ = std_acc;
+	std_yaw_rate_ = std_yaw_rate;
+
+	// Measurement covariance
+	R_ = MeasurementMatrix::Zero(dim_z_, dim_z_);
+	R_(0,0) = std_lidar_x * std_lidar_x;
+	R_(1,1) = std_lidar_y * std_lidar_y;
+
+	// Define weights for UKF
+	weights_ = WeightVector::Constant(dim_sig_,
+		0.5 / (dim_x_aug_ + lambda_));
+	weights_(0) = lambda_ / (lambda_ + dim_x_aug_);
+}
+
+template<int NX, int NXA, int NZ>
+double UnscentedFilter<NX, NXA, NZ>::normalizeAngle(double angle){
+
+	while(angle >  M_PI) angle -= 2. * M_PI;
+	while(angle < -M_PI) angle += 2. * M_PI;
+	return angle;
+}
+
+template<int NX, int NXA, int NZ>
+bool UnscentedFilter<NX, NXA, NZ>::cholUpdate(StateMatrix & L, StateVector v,
+	const double sign){
+
+	int n = L.rows();
+	for(int k = 0; k < n; k++){
+
+		// New diagonal element
+		double r2 = L(k,k) * L(k,k) + sign * v(k) * v(k);
+		if(!(r2 > 0.0) || L(k,k) <= 0.0)
+			return false;
+		double r = std::sqrt(r2);
+		double c = r / L(k,k);
+		double s = v(k) / L(k,k);
+		L(k,k) = r;
+
+		// Rotate remaining column
+		for(int i = k + 1; i < n; i++){
+			L(i,k) = (L(i,k) + sign * s * v(i)) / c;
+			v(i) = c * v(i) - s * L(i,k);
+		}
+	}
+	return true;
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::generateSigmaPoints(const StateVector & x,
+	const AugStateMatrix & L, AugSigmaMatrix & Xsig_aug) const{
+
+	// Fill augmented mean state
+	AugStateVector x_aug = AugStateVector::Zero(dim_x_aug_);
+	x_aug.template block<NX, 1>(0, 0, dim_x_, 1) = x;
+
+	// Create augmented sigma points
+	double spread = std::sqrt(lambda_ + dim_x_aug_);
+	Xsig_aug.col(0) = x_aug;
+	for(int j = 0; j < dim_x_aug_; j++){
+		Xsig_aug.col(j + 1) = x_aug + spread * L.col(j);
+		Xsig_aug.col(j + 1 + dim_x_aug_) = x_aug - spread * L.col(j);
+	}
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::predictSigmaPoints(
+	const AugSigmaMatrix & Xsig_aug, SigmaMatrix & Xsig_pred,
+	const double delta_t) const{
+
+	for(int j = 0; j < dim_sig_; j++){
+
+		// Grab values for better readability
+		double p_x = Xsig_aug(0,j);
+		double p_y = Xsig_aug(1,j);
+		double v = Xsig_aug(2,j);
+		double yaw = Xsig_aug(3,j);
+		double yawd = Xsig_aug(4,j);
+		double nu_a = Xsig_aug(5,j);
+		double nu_yawdd = Xsig_aug(6,j);
+
+		// Predicted state values
+		double px_p, py_p;
+
+		// Avoid division by zero
+		if(std::fabs(yawd) > 0.001){
+			px_p = p_x + v/yawd * (std::sin(yaw + yawd * delta_t) - std::sin(yaw));
+			py_p = p_y + v/yawd * (std::cos(yaw) - std::cos(yaw + yawd * delta_t));
+		}
+		else {
+			px_p = p_x + v * delta_t * std::cos(yaw);
+			py_p = p_y + v * delta_t * std::sin(yaw);
+		}
+		double v_p = v;
+		double yaw_p = yaw + yawd * delta_t;
+		double yawd_p = yawd;
+
+		// Add noise
+		px_p = px_p + 0.5 * nu_a * delta_t * delta_t * std::cos(yaw);
+		py_p = py_p + 0.5 * nu_a * delta_t * delta_t * std::sin(yaw);
+		v_p = v_p + nu_a * delta_t;
+		yaw_p = yaw_p + 0.5 * nu_yawdd * delta_t * delta_t;
+		yawd_p = yawd_p + nu_yawdd * delta_t;
+
+		// Write predicted sigma point into right column
+		Xsig_pred(0,j) = px_p;
+		Xsig_pred(1,j) = py_p;
+		Xsig_pred(2,j) = v_p;
+		Xsig_pred(3,j) = yaw_p;
+		Xsig_pred(4,j) = yawd_p;
+	}
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::predict(StateVector & x, StateMatrix & P,
+	SigmaMatrix & Xsig_pred, const double delta_t) const{
+
+/******************************************************************************
+ * 1. Generate augmented sigma points
+ */
+
+	// Fill augmented covariance matrix
+	AugStateMatrix P_aug = AugStateMatrix::Zero(dim_x_aug_, dim_x_aug_);
+	P_aug.template block<NX, NX>(0, 0, dim_x_, dim_x_) = P;
+	P_aug(5,5) = std_acc_ * std_acc_;
+	P_aug(6,6) = std_yaw_rate_ * std_yaw_rate_;
+
+	// Create square root matrix
+	AugStateMatrix L = P_aug.llt().matrixL();
+
+	// Create augmented sigma points
+	AugSigmaMatrix Xsig_aug(dim_x_aug_, dim_sig_);
+	generateSigmaPoints(x, L, Xsig_aug);
+
+/******************************************************************************
+ * 2. Predict sigma points
+ */
+
+	predictSigmaPoints(Xsig_aug, Xsig_pred, delta_t);
+
+/******************************************************************************
+ * 3. Predict state vector and state covariance
+ */
+
+	// Predicted state mean
+	x = Xsig_pred * weights_;
+
+	// Predicted state covariance matrix
+	P.setZero();
+	for(int j = 0; j < dim_sig_; j++) {
+
+		// State difference
+		StateVector x_diff = Xsig_pred.col(j) - x;
+		x_diff(3) = normalizeAngle(x_diff(3));
+
+		P.noalias() += weights_(j) * x_diff * x_diff.transpose();
+	}
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::predictSqrt(StateVector & x,
+	StateMatrix & L, SigmaMatrix & Xsig_pred, const double delta_t) const{
+
+/******************************************************************************
+ * 1. Generate augmented sigma points
+ */
+
+	// The noise is independent of the state, so the augmented factor is block
+	// diagonal and needs no factorization
+	AugStateMatrix L_aug = AugStateMatrix::Zero(dim_x_aug_, dim_x_aug_);
+	L_aug.template block<NX, NX>(0, 0, dim_x_, dim_x_) = L;
+	L_aug(5,5) = std_acc_;
+	L_aug(6,6) = std_yaw_rate_;
+
+	AugSigmaMatrix Xsig_aug(dim_x_aug_, dim_sig_);
+	generateSigmaPoints(x, L_aug, Xsig_aug);
+
+/******************************************************************************
+ * 2. Predict sigma points
+ */
+
+	predictSigmaPoints(Xsig_aug, Xsig_pred, delta_t);
+
+/******************************************************************************
+ * 3. Predict state vector and factor of the state covariance
+ */
+
+	// Predicted state mean
+	x = Xsig_pred * weights_;
+
+	// Weighted deviations of the sigma points with non negative weights
+	Matrix<double, DimSig, NX> A(dim_sig_, dim_x_);
+	int first = weights_(0) < 0.0 ? 1 : 0;
+	A.setZero();
+	for(int j = first; j < dim_sig_; j++) {
+		StateVector x_diff = Xsig_pred.col(j) - x;
+		x_diff(3) = normalizeAngle(x_diff(3));
+		A.row(j) = std::sqrt(weights_(j)) * x_diff.transpose();
+	}
+
+	// P = A^T * A = R^T * R, the lower factor is R^T with positive diagonal
+	HouseholderQR<Matrix<double, DimSig, NX> > qr(A);
+	L = qr.matrixQR().template block<NX, NX>(0, 0, dim_x_, dim_x_)
+		.template triangularView<Upper>().transpose();
+	for(int k = 0; k < dim_x_; k++){
+		if(L(k,k) < 0.0)
+			L.col(k) = -L.col(k);
+	}
+
+	// Negative center weight is a downdate, refactorize if it fails
+	if(first == 1){
+		StateVector x_diff = Xsig_pred.col(0) - x;
+		x_diff(3) = normalizeAngle(x_diff(3));
+		StateMatrix L_down = L;
+		if(cholUpdate(L_down, std::sqrt(-weights_(0)) * x_diff, -1.0)){
+			L = L_down;
+		}
+		else{
+			StateMatrix P = L * L.transpose() +
+				weights_(0) * x_diff * x_diff.transpose();
+			L = P.llt().matrixL();
+		}
+	}
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::predictMeasurement(const StateVector & x,
+	const StateMatrix & P, const SigmaMatrix & Xsig_pred,
+	Innovation & inn) const{
+
+	// Measurement sigma points
+	MeasurementSigmaMatrix Zsig =
+		Xsig_pred.template block<NZ, DimSig>(0, 0, dim_z_, dim_sig_);
+
+	// Mean predicted measurement
+	inn.z_pred = Zsig * weights_;
+
+	// Innovation covariance and cross correlation
+	inn.S = R_;
+	inn.Tc = GainMatrix::Zero(dim_x_, dim_z_);
+	for(int j = 0; j < dim_sig_; j++) {
+
+		// Residual
+		MeasurementVector z_sig_diff = Zsig.col(j) - inn.z_pred;
+		inn.S.noalias() += weights_(j) * z_sig_diff * z_sig_diff.transpose();
+
+		// State difference
+		StateVector x_diff = Xsig_pred.col(j) - x;
+		x_diff(3) = normalizeAngle(x_diff(3));
+
+		inn.Tc.noalias() += weights_(j) * x_diff * z_sig_diff.transpose();
+	}
+	inn.S_inv = invertInnovation(inn.S);
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::predictMeasurement(const StateVector & x,
+	const StateMatrix & P, Innovation & inn) const{
+
+	// Measurement picks the first components, P * H^T are the first columns
+	inn.z_pred = x.template block<NZ, 1>(0, 0, dim_z_, 1);
+	inn.Tc = P.template block<NX, NZ>(0, 0, dim_x_, dim_z_);
+	inn.S = inn.Tc.template block<NZ, NZ>(0, 0, dim_z_, dim_z_) + R_;
+	inn.S_inv = invertInnovation(inn.S);
+}
+
+template<int NX, int NXA, int NZ>
+double UnscentedFilter<NX, NXA, NZ>::mahalanobis(const Innovation & inn,
+	const MeasurementVector & z) const{
+
+	MeasurementVector z_diff = z - inn.z_pred;
+	return z_diff.dot(inn.S_inv * z_diff);
+}
+
+template<int NX, int NXA, int NZ>
+double UnscentedFilter<NX, NXA, NZ>::update(StateVector & x, StateMatrix & P,
+	const Innovation & inn, const MeasurementVector & z) const{
+
+	// Kalman gain K = Tc * S^-1
+	MeasurementVector z_diff = z - inn.z_pred;
+	GainMatrix K = inn.Tc * inn.S_inv;
+
+	// Update state mean and covariance matrix, K * S * K^T = K * Tc^T
+	x += K * z_diff;
+	P.noalias() -= K * inn.Tc.transpose();
+
+	// Gaussian likelihood of the innovation
+	double mahalanobis = z_diff.dot(inn.S_inv * z_diff);
+	return std::exp(-0.5 * mahalanobis) /
+		std::sqrt(std::pow(2.0 * M_PI, dim_z_) * inn.S.determinant());
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::update(StateVector & x, StateMatrix & P,
+	const SigmaMatrix & Xsig_pred, const MeasurementVector & z) const{
+
+	Innovation inn;
+	predictMeasurement(x, P, Xsig_pred, inn);
+	update(x, P, inn, z);
+}
+
+template<int NX, int NXA, int NZ>
+typename UnscentedFilter<NX, NXA, NZ>::MeasurementMatrix
+	UnscentedFilter<NX, NXA, NZ>::invertInnovation(
+	const MeasurementMatrix & S) const{
+
+	if(dim_z_ != 2)
+		return S.inverse();
+
+	// Closed form inverse of a 2x2 matrix
+	MeasurementMatrix S_inv(2, 2);
+	double det = S(0,0) * S(1,1) - S(0,1) * S(1,0);
+	S_inv(0,0) = S(1,1) / det;
+	S_inv(0,1) = -S(0,1) / det;
+	S_inv(1,0) = -S(1,0) / det;
+	S_inv(1,1) = S(0,0) / det;
+	return S_inv;
+}
+
+template<int NX, int NXA, int NZ>
+double UnscentedFilter<NX, NXA, NZ>::updateLinear(StateVector & x,
+	StateMatrix & P, const MeasurementVector & z) const{
+
+	Innovation inn;
+	predictMeasurement(x, P, inn);
+	return update(x, P, inn, z);
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::updateSqrt(StateVector & x,
+	StateMatrix & L, const MeasurementVector & z) const{
+
+	Innovation inn;
+	predictMeasurement(x, StateMatrix(L * L.transpose()), inn);
+	updateSqrt(x, L, inn, z);
+}
+
+template<int NX, int NXA, int NZ>
+void UnscentedFilter<NX, NXA, NZ>::updateSqrt(StateVector & x,
+	StateMatrix & L, const Innovation & inn,
+	const MeasurementVector & z) const{
+
+	// Linear update of the mean
+	GainMatrix K = inn.Tc * inn.S_inv;
+	x += K * (z - inn.z_pred);
+
+	// P - K * S * K^T = P - U * U^T with U = K * chol(S), one downdate per
+	// column of U, refactorize if it fails
+	GainMatrix U = K * MeasurementMatrix(inn.S.llt().matrixL());
+	StateMatrix L_down = L;
+	for(int k = 0; k < dim_z_; k++){
+		if(!cholUpdate(L_down, U.col(k), -1.0)){
+			StateMatrix P = L * L.transpose();
+			P.noalias() -= K * inn.Tc.transpose();
+			L = P.llt().matrixL();
+			return;
+		}
+	}
+	L = L_down;
+}
+
+// Filter with state [x, y, v, yaw, yaw_rate], two noise terms and [x, y]
+#ifdef TRACKING_DYNAMIC_UKF
+typedef UnscentedFilter<Dynamic, Dynamic, Dynamic> Filter;
+#else
+typedef UnscentedFilter<5, 7, 2> Filter;
+#endif
+
+} // namespace tracking
+
+#endif // ukf_filter_H
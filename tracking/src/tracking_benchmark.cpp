@@ -0,0 +1,417 @@
+/******************************************************************************
+ *
+ * Scalability benchmark of the tracker on synthetic multi target scenes.
+ * Usage: rosrun tracking tracking_benchmark [--targets 10,100,1000,2000]
+ *        [--frames N] [--clutter F] [--miss P] [--noise S] [--threads N]
+ *        [--imm 0|1] [--mahalanobis 0|1] [--forecast 0|1] [--reorder 0|1]
+ *
+ */
+
+#include <tracking_lib/tracker.h>
+#include <ros/console.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+using namespace tracking;
+
+// Semantic classes as written by the detection
+static const int PEDESTRIAN = 11;
+static const int CAR = 13;
+
+// Frame rate of the sensor
+static const double FRAME_TIME = 0.1;
+
+// Distance within which a track belongs to a target
+static const float MATCH_DIST = 1.0;
+
+// Recorded frames of the out of sequence check, frame 3 of every 10 swaps
+// with its successor and frame 7 arrives 3 frames late
+static const int REORDER_PERIOD = 10;
+static const int REORDER_SWAP = 3;
+static const int REORDER_DELAY = 7;
+static const int REORDER_DELAY_FRAMES = 3;
+static const int REORDER_HISTORY = 10;
+
+struct BenchmarkConfig{
+
+	std::vector<int> targets;
+	int frames;
+	float clutter;
+	float miss;
+	float noise;
+	int threads;
+	bool imm;
+	bool mahalanobis;
+	bool forecast;
+	bool reorder;
+};
+
+// Simulated target with CTRV motion
+struct Target{
+
+	int semantic;
+	double x;
+	double y;
+	double v;
+	double yaw;
+	double yaw_rate;
+};
+
+static std::string getArg(int argc, char ** argv, const std::string & name,
+	const std::string & default_value){
+
+	for(int i = 1; i < argc - 1; ++i){
+		if(name == argv[i])
+			return argv[i + 1];
+	}
+	return default_value;
+}
+
+static std::vector<int> parseList(const std::string & list){
+
+	std::vector<int> values;
+	std::stringstream stream(list);
+	std::string item;
+	while(std::getline(stream, item, ',')){
+		values.push_back(std::atoi(item.c_str()));
+	}
+	return values;
+}
+
+// Same parameters as tracking/config/parameters.yaml
+static Parameter getParameter(const BenchmarkConfig & config){
+
+	Parameter params;
+	params.da_ped_dist_pos = 1.0;
+	params.da_ped_dist_form = 2.0;
+	params.da_car_dist_pos = 2.0;
+	params.da_car_dist_form = 5.0;
+	params.da_mahalanobis = config.mahalanobis;
+	params.da_mahalanobis_gate = 9.21;
+	params.da_mahalanobis_std = 1.0;
+	params.tra_dim_z = 2;
+	params.tra_dim_x = 5;
+	params.tra_dim_x_aug = 7;
+	params.tra_std_lidar_x = 0.15;
+	params.tra_std_lidar_y = 0.15;
+	params.tra_std_acc = 0.4;
+	params.tra_std_yaw_rate = 0.314;
+	params.tra_lambda = 2.0;
+	params.tra_aging_bad = 2;
+	params.tra_batch_prediction = true;
+	params.tra_threads = config.threads;
+	params.tra_linear_update = true;
+	params.tra_square_root = false;
+	params.tra_imm = config.imm;
+	params.tra_imm_p_stay = 0.95;
+	params.tra_imm_mu_cv = 0.5;
+	params.tra_history_depth = 0;
+	params.tra_trajectory_length = 20;
+	params.tra_trajectory_publish = false;
+	params.tra_forecast_publish = config.forecast;
+	params.tra_forecast_step = 0.3;
+	params.tra_forecast_steps = 10;
+	params.tra_snapshot = false;
+	params.tra_snapshot_interval = 0;
+	params.tra_snapshot_max_age = 0.0;
+	params.tra_occ_factor = 2.0;
+	params.p_init_x = 1.0;
+	params.p_init_y = 1.0;
+	params.p_init_v = 10.0;
+	params.p_init_yaw = 10.0;
+	params.p_init_yaw_rate = 1.0;
+	return params;
+}
+
+// Targets spread over a square with constant density, half of them cars
+static std::vector<Target> createTargets(const int n, cv::RNG & rng){
+
+	std::vector<Target> targets(n);
+	double side = 10.0 * std::sqrt(double(n));
+	for(int i = 0; i < n; ++i){
+		Target & t = targets[i];
+		t.semantic = (i % 2) ? CAR : PEDESTRIAN;
+		t.x = rng.uniform(0.0, side);
+		t.y = rng.uniform(0.0, side);
+		t.v = (t.semantic == CAR) ? rng.uniform(0.0, 12.0) :
+			rng.uniform(0.0, 2.0);
+		t.yaw = rng.uniform(-M_PI, M_PI);
+		t.yaw_rate = rng.uniform(-0.3, 0.3);
+	}
+	return targets;
+}
+
+static void moveTargets(std::vector<Target> & targets, cv::RNG & rng){
+
+	for(int i = 0; i < targets.size(); ++i){
+		Target & t = targets[i];
+		double yaw = t.yaw + t.yaw_rate * FRAME_TIME;
+		if(std::fabs(t.yaw_rate) > 0.001){
+			t.x += t.v / t.yaw_rate * (std::sin(yaw) - std::sin(t.yaw));
+			t.y += t.v / t.yaw_rate * (std::cos(t.yaw) - std::cos(yaw));
+		}
+		else{
+			t.x += t.v * FRAME_TIME * std::cos(t.yaw);
+			t.y += t.v * FRAME_TIME * std::sin(t.yaw);
+		}
+		t.yaw = yaw;
+		t.v = std::max(0.0, t.v + rng.gaussian(0.4) * FRAME_TIME);
+		t.yaw_rate += rng.gaussian(0.1) * FRAME_TIME;
+	}
+}
+
+static Object createObject(const int semantic, const double x,
+	const double y){
+
+	Object obj;
+	obj.world_pose.header.frame_id = "world";
+	obj.world_pose.point.x = x;
+	obj.world_pose.point.y = y;
+	obj.world_pose.point.z = 0.0;
+	obj.semantic_id = semantic;
+	obj.semantic_name = (semantic == CAR) ? "Car" : "Pedestrian";
+	obj.semantic_confidence = 1.0;
+	obj.width = (semantic == CAR) ? 1.8 : 0.6;
+	obj.length = (semantic == CAR) ? 4.2 : 0.8;
+	obj.height = (semantic == CAR) ? 1.5 : 1.7;
+	obj.orientation = 0.0;
+	obj.is_track = true;
+	return obj;
+}
+
+// Noisy detections of all targets, missed ones left out, and clutter
+static void createDetections(const std::vector<Target> & targets,
+	const BenchmarkConfig & config, const int frame, cv::RNG & rng,
+	ObjectArray & detected_objects){
+
+	detected_objects.header.stamp = ros::Time(1.0 + frame * FRAME_TIME);
+	detected_objects.list.clear();
+	double side = 10.0 * std::sqrt(double(targets.size()));
+	for(int i = 0; i < targets.size(); ++i){
+		if(rng.uniform(0.f, 1.f) < config.miss)
+			continue;
+		detected_objects.list.push_back(createObject(targets[i].semantic,
+			targets[i].x + rng.gaussian(config.noise),
+			targets[i].y + rng.gaussian(config.noise)));
+	}
+	int clutter = config.clutter * targets.size();
+	for(int i = 0; i < clutter; ++i){
+		detected_objects.list.push_back(createObject(
+			rng.uniform(0, 2) ? CAR : PEDESTRIAN,
+			rng.uniform(0.0, side), rng.uniform(0.0, side)));
+	}
+}
+
+// Arrival order of the recorded frames with swapped and delayed frames
+static std::vector<int> createArrivalOrder(const int frames){
+
+	std::vector<int> order;
+	std::vector<int> delayed;
+	for(int f = 0; f < frames; ++f){
+		int phase = f % REORDER_PERIOD;
+		if(phase == REORDER_SWAP && f + 1 < frames){
+			order.push_back(f + 1);
+			order.push_back(f);
+			f++;
+		}
+		else if(phase == REORDER_DELAY && f > 0){
+			delayed.push_back(f);
+		}
+		else{
+			order.push_back(f);
+		}
+
+		// Delayed frames arrive after their successors
+		for(int k = 0; k < delayed.size(); ++k){
+			if(f == delayed[k] + REORDER_DELAY_FRAMES || f == frames - 1){
+				order.push_back(delayed[k]);
+				delayed.erase(delayed.begin() + k);
+				k--;
+			}
+		}
+	}
+	return order;
+}
+
+// Tracks of both trackers with equal ids, states and covariances
+static bool equalTracks(const TrackPool & a, const TrackPool & b){
+
+	if(a.size() != b.size())
+		return false;
+	for(int i = 0; i < a.size(); ++i){
+		if(a[i].id != b[i].id || a[i].sta.x != b[i].sta.x ||
+			a[i].sta.P != b[i].sta.P || a[i].hist.good_age != b[i].hist.good_age ||
+			a[i].hist.bad_age != b[i].hist.bad_age)
+			return false;
+	}
+	return true;
+}
+
+// Match targets to the closest tracks of the same class, closest pairs first,
+// and count identity switches against the last matched track of each target
+static void countIdentitySwitches(const std::vector<Target> & targets,
+	const TrackPool & tracks, SpatialHash & index,
+	std::vector<int> & last_ids, int & switches, int & matches){
+
+	index.clear(MATCH_DIST);
+	for(int i = 0; i < tracks.size(); ++i)
+		index.add(tracks[i].sta.x(0), tracks[i].sta.x(1), i);
+	index.build();
+
+	std::vector<std::pair<double, std::pair<int, int> > > pairs;
+	std::vector<int> nearby;
+	for(int t = 0; t < targets.size(); ++t){
+		index.query(targets[t].x, targets[t].y, MATCH_DIST, nearby);
+		for(int k = 0; k < nearby.size(); ++k){
+			const Track & track = tracks[nearby[k]];
+			double dist = std::hypot(track.sta.x(0) - targets[t].x,
+				track.sta.x(1) - targets[t].y);
+			if(track.sem.id == targets[t].semantic && dist < MATCH_DIST)
+				pairs.push_back(std::make_pair(dist,
+					std::make_pair(t, nearby[k])));
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+
+	std::vector<bool> target_used(targets.size(), false);
+	std::vector<bool> track_used(tracks.size(), false);
+	for(int k = 0; k < pairs.size(); ++k){
+		int t = pairs[k].second.first;
+		int i = pairs[k].second.second;
+		if(target_used[t] || track_used[i])
+			continue;
+		target_used[t] = true;
+		track_used[i] = true;
+		matches++;
+		if(last_ids[t] >= 0 && last_ids[t] != tracks[i].id)
+			switches++;
+		last_ids[t] = tracks[i].id;
+	}
+}
+
+int main(int argc, char **argv){
+
+	// Read configuration
+	BenchmarkConfig config;
+	config.targets = parseList(
+		getArg(argc, argv, "--targets", "10,50,100,200,500,1000,2000"));
+	config.frames = std::atoi(getArg(argc, argv, "--frames", "50").c_str());
+	config.clutter = std::atof(getArg(argc, argv, "--clutter", "0.1").c_str());
+	config.miss = std::atof(getArg(argc, argv, "--miss", "0.05").c_str());
+	config.noise = std::atof(getArg(argc, argv, "--noise", "0.1").c_str());
+	config.threads = std::atoi(getArg(argc, argv, "--threads", "1").c_str());
+	config.imm = std::atoi(getArg(argc, argv, "--imm", "0").c_str()) != 0;
+	config.mahalanobis = std::atoi(
+		getArg(argc, argv, "--mahalanobis", "0").c_str()) != 0;
+	config.forecast = std::atoi(
+		getArg(argc, argv, "--forecast", "0").c_str()) != 0;
+	config.reorder = std::atoi(
+		getArg(argc, argv, "--reorder", "0").c_str()) != 0;
+
+	// Per track warnings would dominate the run time
+	ros::Time::init();
+	if(ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME,
+		ros::console::levels::Error))
+		ros::console::notifyLoggerLevelsChanged();
+
+	std::printf("Tracking benchmark: %d frames, %.2f clutter per target,"
+		" %.2f miss probability, %.2f m noise, %d threads, imm %d,"
+		" mahalanobis %d, forecast %d, reorder %d\n", config.frames,
+		config.clutter, config.miss, config.noise, config.threads,
+		int(config.imm), int(config.mahalanobis), int(config.forecast),
+		int(config.reorder));
+	std::printf("%7s %7s %7s %10s %10s %10s %10s %10s %10s %8s %8s\n",
+		"targets", "objects", "tracks", "predict[ms]", "assoc[ms]",
+		"update[ms]", "manage[ms]", "forecast[ms]", "total[ms]", "matched",
+		"id_sw");
+
+	std::vector<std::string> reorder_rows;
+	for(int r = 0; r < config.targets.size(); ++r){
+
+		// Create tracker and scene for this number of targets
+		cv::RNG rng(2345);
+		Tracker tracker;
+		tracker.init(getParameter(config));
+		std::vector<Target> targets = createTargets(config.targets[r], rng);
+
+		ObjectArray detected_objects;
+		ForecastArray forecasts;
+		SpatialHash index;
+		std::vector<int> last_ids(targets.size(), -1);
+		int switches = 0;
+		int matches = 0;
+		int objects = 0;
+		std::vector<ObjectArray> recorded;
+		for(int f = 0; f < config.frames; ++f){
+
+			createDetections(targets, config, f, rng, detected_objects);
+			objects += detected_objects.list.size();
+			if(config.reorder)
+				recorded.push_back(detected_objects);
+			tracker.process(detected_objects);
+			if(config.forecast)
+				tracker.getForecastList(forecasts);
+
+			// Identities from the second frame on, after the first update
+			if(f > 0)
+				countIdentitySwitches(targets, tracker.getTracks(), index,
+					last_ids, switches, matches);
+			moveTargets(targets, rng);
+		}
+
+		// Report mean timings per frame and identity metrics
+		const StageTimes & times = tracker.getStageTimes();
+		int frames = std::max(1, times.frames);
+		double total = times.prediction + times.association + times.update +
+			times.management + times.forecast;
+		std::printf("%7d %7d %7d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f"
+			" %8.3f %8d\n", config.targets[r], objects / config.frames,
+			tracker.getTracks().size(), times.prediction / frames,
+			times.association / frames, times.update / frames,
+			times.management / frames, times.forecast / frames, total / frames,
+			double(matches) / std::max(1, int(targets.size()) *
+			(config.frames - 1)), switches);
+
+		// Same frames in order and out of sequence with a history, both must
+		// end with identical tracks
+		if(config.reorder){
+
+			Parameter params = getParameter(config);
+			params.tra_history_depth = REORDER_HISTORY;
+			Tracker in_order;
+			Tracker out_of_order;
+			in_order.init(params);
+			out_of_order.init(params);
+
+			for(int f = 0; f < recorded.size(); ++f)
+				in_order.process(recorded[f]);
+			std::vector<int> order = createArrivalOrder(recorded.size());
+			for(int k = 0; k < order.size(); ++k)
+				out_of_order.process(recorded[order[k]]);
+
+			const ReplayStatistics & stats =
+				out_of_order.getReplayStatistics();
+			char row[256];
+			std::snprintf(row, sizeof(row), "%7d %7d %7d %7d %10.3f %10s",
+				config.targets[r], stats.late_frames, stats.dropped_frames,
+				stats.max_depth, stats.total_time /
+				std::max(1, stats.late_frames),
+				equalTracks(in_order.getTracks(), out_of_order.getTracks()) ?
+				"yes" : "no");
+			reorder_rows.push_back(row);
+		}
+	}
+
+	// Out of sequence check
+	if(config.reorder){
+		std::printf("%7s %7s %7s %7s %10s %10s\n", "targets", "late",
+			"dropped", "depth", "replay[ms]", "identical");
+		for(int r = 0; r < reorder_rows.size(); ++r)
+			std::printf("%s\n", reorder_rows[r].c_str());
+	}
+
+	return 0;
+}
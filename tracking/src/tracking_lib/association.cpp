@@ -0,0 +1,158 @@
+#include <tracking_lib/association.h>
+#include <algorithm>
+
+namespace tracking{
+
+// Cost of forbidden pairs, larger than any sum of gated costs
+static const double FORBIDDEN = 1e12;
+
+/******************************************************************************/
+
+GatedAssignment::GatedAssignment(){
+
+}
+
+GatedAssignment::~GatedAssignment(){
+
+}
+
+int GatedAssignment::getNumberOfComponents() const{
+
+	return component_begin_.empty() ? 0 : component_begin_.size() - 1;
+}
+
+int GatedAssignment::findRoot(int node){
+
+	// Path halving
+	while(parent_[node] != node){
+		parent_[node] = parent_[parent_[node]];
+		node = parent_[node];
+	}
+	return node;
+}
+
+void GatedAssignment::solve(const int num_tracks, const int num_objects,
+	const std::vector<Candidate> & candidates,
+	const std::vector<float> & miss_costs, ThreadPool & pool,
+	std::vector<int> & track_to_object, std::vector<int> & object_to_track){
+
+	track_to_object.assign(num_tracks, -1);
+	object_to_track.assign(num_objects, -1);
+
+/******************************************************************************
+ * 1. Connect tracks and objects sharing a candidate
+ */
+
+	parent_.resize(num_tracks + num_objects);
+	for(int i = 0; i < parent_.size(); ++i)
+		parent_[i] = i;
+
+	for(int k = 0; k < candidates.size(); ++k){
+		int a = findRoot(candidates[k].track);
+		int b = findRoot(num_tracks + candidates[k].object);
+		if(a != b)
+			parent_[std::max(a, b)] = std::min(a, b);
+	}
+
+/******************************************************************************
+ * 2. Group candidates by component, ordered by their smallest track
+ */
+
+	// Number components with candidates by their root track
+	std::vector<int> component_of_root(num_tracks, -1);
+	for(int k = 0; k < candidates.size(); ++k)
+		component_of_root[findRoot(candidates[k].track)] = -2;
+	int num_components = 0;
+	for(int i = 0; i < num_tracks; ++i){
+		if(component_of_root[i] == -2)
+			component_of_root[i] = num_components++;
+	}
+
+	// Counting sort of candidates by component
+	component_begin_.assign(num_components + 1, 0);
+	std::vector<int> component_of_candidate(candidates.size());
+	for(int k = 0; k < candidates.size(); ++k){
+		int c = component_of_root[findRoot(candidates[k].track)];
+		component_of_candidate[k] = c;
+		component_begin_[c + 1]++;
+	}
+	for(int c = 0; c < num_components; ++c)
+		component_begin_[c + 1] += component_begin_[c];
+	component_candidates_.resize(candidates.size());
+	std::vector<int> fill(component_begin_.begin(), component_begin_.end() - 1);
+	for(int k = 0; k < candidates.size(); ++k)
+		component_candidates_[fill[component_of_candidate[k]]++] = k;
+
+/******************************************************************************
+ * 3. Solve components independently
+ */
+
+	// Components write disjoint tracks and objects
+	pool.parallelFor(num_components, 1,
+		[&](const int worker, const int begin, const int end){
+
+		for(int c = begin; c < end; ++c)
+			solveComponent(c, candidates, miss_costs, track_to_object,
+				object_to_track);
+	});
+}
+
+void GatedAssignment::solveComponent(const int component,
+	const std::vector<Candidate> & candidates,
+	const std::vector<float> & miss_costs, std::vector<int> & track_to_object,
+	std::vector<int> & object_to_track) const{
+
+	int begin = component_begin_[component];
+	int end = component_begin_[component + 1];
+
+	// Single candidate, assign if cheaper than missing
+	if(end - begin == 1){
+		const Candidate & cand = candidates[component_candidates_[begin]];
+		if(cand.cost < miss_costs[cand.track]){
+			track_to_object[cand.track] = cand.object;
+			object_to_track[cand.object] = cand.track;
+		}
+		return;
+	}
+
+	// Local indices of tracks and objects
+	std::vector<int> tracks;
+	std::vector<int> objects;
+	for(int k = begin; k < end; ++k){
+		tracks.push_back(candidates[component_candidates_[k]].track);
+		objects.push_back(candidates[component_candidates_[k]].object);
+	}
+	std::sort(tracks.begin(), tracks.end());
+	tracks.erase(std::unique(tracks.begin(), tracks.end()), tracks.end());
+	std::sort(objects.begin(), objects.end());
+	objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+
+	// Cost matrix of objects and one miss column per track
+	int rows = tracks.size();
+	int cols = objects.size();
+	Eigen::MatrixXd cost = Eigen::MatrixXd::Constant(rows, cols + rows,
+		FORBIDDEN);
+	for(int i = 0; i < rows; ++i)
+		cost(i, cols + i) = miss_costs[tracks[i]];
+	for(int k = begin; k < end; ++k){
+		const Candidate & cand = candidates[component_candidates_[k]];
+		int i = std::lower_bound(tracks.begin(), tracks.end(), cand.track) -
+			tracks.begin();
+		int j = std::lower_bound(objects.begin(), objects.end(), cand.object) -
+			objects.begin();
+		cost(i, j) = std::min(cost(i, j), double(cand.cost));
+	}
+
+	// Minimum cost assignment
+	std::vector<int> row_to_col;
+	Assignment::solve(cost, row_to_col);
+	for(int i = 0; i < rows; ++i){
+		int j = row_to_col[i];
+		if(j >= 0 && j < cols && cost(i, j) < FORBIDDEN){
+			track_to_object[tracks[i]] = objects[j];
+			object_to_track[objects[j]] = tracks[i];
+		}
+	}
+}
+
+} // namespace tracking
@@ -0,0 +1,112 @@
+#include <tracking_lib/imm.h>
+
+namespace tracking{
+
+/******************************************************************************/
+
+InteractingModels::InteractingModels(){
+
+	init(1.0);
+}
+
+InteractingModels::~InteractingModels(){
+
+}
+
+void InteractingModels::init(const double p_stay){
+
+	for(int i = 0; i < NUM_MODELS; ++i){
+		for(int j = 0; j < NUM_MODELS; ++j){
+			transition_[i][j] = (i == j) ? p_stay :
+				(1.0 - p_stay) / (NUM_MODELS - 1);
+		}
+	}
+}
+
+void InteractingModels::merge(const ModelSet & models,
+	const double weights[NUM_MODELS], Filter::StateVector & x,
+	Filter::StateMatrix & P) const{
+
+	// Mean with yaw averaged as offset to the first model
+	const Filter::StateVector & x_ref = models.x[0];
+	x = Filter::StateVector::Zero(x_ref.size());
+	for(int i = 1; i < NUM_MODELS; ++i){
+		Filter::StateVector x_diff = models.x[i] - x_ref;
+		x_diff(3) = Filter::normalizeAngle(x_diff(3));
+		x += weights[i] * x_diff;
+	}
+	x += x_ref;
+
+	// Covariance with spread of the means, for weights summing to one the
+	// spread around the mean is the weighted spread of all pairs, a single
+	// outer product for two models
+	P = weights[0] * models.P[0];
+	for(int i = 1; i < NUM_MODELS; ++i)
+		P.noalias() += weights[i] * models.P[i];
+	for(int i = 0; i < NUM_MODELS; ++i){
+		for(int j = i + 1; j < NUM_MODELS; ++j){
+			Filter::StateVector x_diff = models.x[j] - models.x[i];
+			x_diff(3) = Filter::normalizeAngle(x_diff(3));
+			P.noalias() += (weights[i] * weights[j]) *
+				x_diff * x_diff.transpose();
+		}
+	}
+}
+
+void InteractingModels::mix(ModelSet & models) const{
+
+	// Predicted model probabilities
+	double c[NUM_MODELS];
+	for(int j = 0; j < NUM_MODELS; ++j){
+		c[j] = 0.0;
+		for(int i = 0; i < NUM_MODELS; ++i)
+			c[j] += transition_[i][j] * models.mu[i];
+	}
+
+	// Mixed initial state of each model
+	Filter::StateVector x_mixed[NUM_MODELS];
+	Filter::StateMatrix P_mixed[NUM_MODELS];
+	for(int j = 0; j < NUM_MODELS; ++j){
+
+		// Keep the state of a model that nothing transitions into
+		if(!(c[j] > 0.0)){
+			x_mixed[j] = models.x[j];
+			P_mixed[j] = models.P[j];
+			continue;
+		}
+
+		double weights[NUM_MODELS];
+		for(int i = 0; i < NUM_MODELS; ++i)
+			weights[i] = transition_[i][j] * models.mu[i] / c[j];
+		merge(models, weights, x_mixed[j], P_mixed[j]);
+	}
+
+	for(int j = 0; j < NUM_MODELS; ++j){
+		models.x[j] = x_mixed[j];
+		models.P[j] = P_mixed[j];
+		models.mu[j] = c[j];
+	}
+}
+
+void InteractingModels::update(ModelSet & models,
+	const double likelihood[NUM_MODELS]) const{
+
+	double sum = 0.0;
+	for(int j = 0; j < NUM_MODELS; ++j)
+		sum += likelihood[j] * models.mu[j];
+
+	// Keep predicted probabilities if the measurement fits no model
+	if(!(sum > 0.0))
+		return;
+
+	for(int j = 0; j < NUM_MODELS; ++j)
+		models.mu[j] = likelihood[j] * models.mu[j] / sum;
+}
+
+void InteractingModels::combine(const ModelSet & models,
+	Filter::StateVector & x, Filter::StateMatrix & P) const{
+
+	merge(models, models.mu, x, P);
+}
+
+} // namespace tracking
@@ -0,0 +1,130 @@
+#include <tracking_lib/replay.h>
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+#include <tf/transform_datatypes.h>
+#include <tf2_msgs/TFMessage.h>
+
+namespace tracking{
+
+/******************************************************************************/
+
+SequenceReplay::SequenceReplay(){
+
+}
+
+SequenceReplay::~SequenceReplay(){
+
+}
+
+int SequenceReplay::size() const{
+
+	return frames_.size();
+}
+
+bool SequenceReplay::open(const std::string & filename){
+
+	frames_.clear();
+
+	try{
+		rosbag::Bag bag;
+		bag.open(filename, rosbag::bagmode::Read);
+
+		std::vector<std::string> topics;
+		topics.push_back("/detection/objects");
+		topics.push_back("/tf");
+		topics.push_back("/tf_static");
+		rosbag::View view(bag, rosbag::TopicQuery(topics));
+
+		// Keep all transforms of the sequence
+		transforms_.reset(new tf2::BufferCore(
+			view.getEndTime() - view.getBeginTime() + ros::Duration(1.0)));
+
+		for(rosbag::View::iterator it = view.begin(); it != view.end(); ++it){
+
+			// Detected objects
+			ObjectArrayConstPtr objects = it->instantiate<ObjectArray>();
+			if(objects){
+				frames_.push_back(*objects);
+				continue;
+			}
+
+			// Transforms
+			tf2_msgs::TFMessageConstPtr tf = it->instantiate<tf2_msgs::TFMessage>();
+			if(tf){
+				bool is_static = it->getTopic() == "/tf_static";
+				for(int i = 0; i < tf->transforms.size(); ++i)
+					transforms_->setTransform(tf->transforms[i], "replay",
+						is_static);
+			}
+		}
+		bag.close();
+	}
+	catch(rosbag::BagException & ex){
+		ROS_ERROR("Failed to read bag %s: %s", filename.c_str(), ex.what());
+		return false;
+	}
+
+	return true;
+}
+
+bool SequenceReplay::transformPoint(const std::string & target_frame,
+	const geometry_msgs::PointStamped & in,
+	geometry_msgs::PointStamped & out) const{
+
+	try{
+		tf::StampedTransform transform;
+		tf::transformStampedMsgToTF(transforms_->lookupTransform(target_frame,
+			in.header.frame_id, in.header.stamp), transform);
+		tf::Vector3 point = transform * tf::Vector3(in.point.x, in.point.y,
+			in.point.z);
+		out.header.frame_id = target_frame;
+		out.header.stamp = in.header.stamp;
+		out.point.x = point.x();
+		out.point.y = point.y();
+		out.point.z = point.z();
+	}
+	catch(tf2::TransformException & ex){
+		ROS_ERROR("Received an exception trying to transform a point from"
+			"\"world\" to \"%s\": %s", target_frame.c_str(), ex.what());
+		return false;
+	}
+	return true;
+}
+
+int SequenceReplay::run(const Parameter & params, std::ostream & results,
+	std::vector<KittiRecord> * records){
+
+	Tracker tracker;
+	tracker.init(params);
+
+	int written = 0;
+	ObjectArray track_list;
+	for(int frame = 0; frame < frames_.size(); ++frame){
+
+		// Prediction, data association, update and track management
+		tracker.process(frames_[frame]);
+		tracker.getTrackList(track_list);
+
+		// Write tracks like the evaluation node
+		for(int i = 0; i < track_list.list.size(); ++i){
+
+			Object & o = track_list.list[i];
+			o.world_pose.header.stamp = frames_[frame].header.stamp;
+
+			geometry_msgs::PointStamped cam_pose;
+			if(!transformPoint("camera_color_left", o.world_pose, cam_pose) ||
+				!transformPoint("velo_link", o.world_pose, o.velo_pose))
+				continue;
+
+			tools_.writeKittiLine(results, frame, o, cam_pose.point);
+			if(records){
+				records->push_back(KittiRecord());
+				tools_.getKittiRecord(frame, o, cam_pose.point, records->back());
+			}
+			written++;
+		}
+	}
+	return written;
+}
+
+} // namespace tracking
@@ -0,0 +1,262 @@
+#include <tracking_lib/sigma_batch.h>
+#include <tracking_lib/sigma_kernel.h>
+
+namespace tracking{
+
+// Entries per block of the covariance reduction
+static const int BLOCK_SIZE = 64;
+
+/******************************************************************************/
+
+SigmaPointBatch::SigmaPointBatch():
+	dim_x_(0),
+	dim_x_aug_(0),
+	dim_sig_(0),
+	spread_(0.0),
+	std_acc_(0.0),
+	std_yaw_rate_(0.0),
+	size_(0),
+	straight_(0),
+	capacity_(0)
+	{
+}
+
+SigmaPointBatch::~SigmaPointBatch(){
+
+}
+
+void SigmaPointBatch::init(const Filter & filter){
+
+	// Filter parameters
+	dim_x_ = filter.dimX();
+	dim_x_aug_ = filter.dimXAug();
+	dim_sig_ = filter.dimSig();
+	spread_ = std::sqrt(filter.lambda() + dim_x_aug_);
+	std_acc_ = filter.stdAcc();
+	std_yaw_rate_ = filter.stdYawRate();
+	weights_ = filter.weights();
+
+	// Buffers
+	aug_.assign(dim_x_aug_, ArrayXd());
+	pred_.assign(dim_x_, ArrayXd());
+	trig_.assign(4, ArrayXd());
+	mean_.assign(dim_x_, ArrayXd());
+	cov_.assign(dim_x_ * (dim_x_ + 1) / 2, ArrayXd());
+	diff_.assign(dim_x_ + 1, MatrixXd(dim_sig_, BLOCK_SIZE));
+	size_ = 0;
+	straight_ = 0;
+	capacity_ = 0;
+}
+
+void SigmaPointBatch::clear(){
+
+	size_ = 0;
+	straight_ = 0;
+}
+
+int SigmaPointBatch::size() const{
+
+	return size_;
+}
+
+void SigmaPointBatch::reserve(const int capacity){
+
+	if(capacity <= capacity_)
+		return;
+
+	// Grow geometrically and keep already generated sigma points
+	capacity_ = std::max(capacity, 2 * capacity_);
+	for(int c = 0; c < aug_.size(); ++c)
+		aug_[c].conservativeResize(capacity_ * dim_sig_);
+	for(int c = 0; c < pred_.size(); ++c)
+		pred_[c].resize(capacity_ * dim_sig_);
+	for(int c = 0; c < trig_.size(); ++c)
+		trig_[c].resize(capacity_ * dim_sig_);
+	for(int c = 0; c < mean_.size(); ++c)
+		mean_[c].resize(capacity_);
+	for(int c = 0; c < cov_.size(); ++c)
+		cov_[c].resize(capacity_);
+}
+
+int SigmaPointBatch::add(const Filter::StateVector & x,
+	const Filter::StateMatrix & P, const MotionModel model){
+
+	reserve(size_ + 1);
+	int offset = size_ * dim_sig_;
+
+	// Augmented covariance is block diagonal, so only P needs a square root.
+	// Constant velocity has no yaw rate, its sigma points do not spread along
+	// the yaw rate.
+	Filter::StateMatrix L;
+	int dim_spread = dim_x_;
+	if(model == MODEL_CV){
+		dim_spread = 4;
+		Matrix4d P_cv = P.topLeftCorner<4, 4>();
+		L = Filter::StateMatrix::Zero(dim_x_, dim_x_);
+		L.topLeftCorner<4, 4>() = P_cv.llt().matrixL();
+	}
+	else{
+		L = P.llt().matrixL();
+	}
+
+	// Augmented mean state for all sigma points
+	for(int c = 0; c < dim_x_aug_; ++c){
+		double mean = (c < dim_spread) ? x(c) : 0.0;
+		aug_[c].segment(offset, dim_sig_).setConstant(mean);
+	}
+
+	// Spread along the columns of the square root
+	for(int j = 0; j < dim_x_; ++j){
+		for(int c = 0; c < dim_x_; ++c){
+			aug_[c](offset + 1 + j) += spread_ * L(c,j);
+			aug_[c](offset + 1 + j + dim_x_aug_) -= spread_ * L(c,j);
+		}
+	}
+
+	// Spread of the noise terms
+	aug_[dim_x_](offset + 1 + dim_x_) += spread_ * std_acc_;
+	aug_[dim_x_](offset + 1 + dim_x_ + dim_x_aug_) -= spread_ * std_acc_;
+	if(model == MODEL_CTRV){
+		aug_[dim_x_ + 1](offset + 2 + dim_x_) += spread_ * std_yaw_rate_;
+		aug_[dim_x_ + 1](offset + 2 + dim_x_ + dim_x_aug_) -=
+			spread_ * std_yaw_rate_;
+	}
+
+	if(model == MODEL_CV && straight_ == size_)
+		straight_++;
+
+	return size_++;
+}
+
+void SigmaPointBatch::predict(const double delta_t){
+
+	// Motion model over the component arrays, leading constant velocity
+	// entries skip the turning part
+	SigmaKernelArrays arrays;
+	arrays.p_x = aug_[0].data();
+	arrays.p_y = aug_[1].data();
+	arrays.v = aug_[2].data();
+	arrays.yaw = aug_[3].data();
+	arrays.yawd = aug_[4].data();
+	arrays.nu_a = aug_[5].data();
+	arrays.nu_yawdd = aug_[6].data();
+	arrays.px_p = pred_[0].data();
+	arrays.py_p = pred_[1].data();
+	arrays.v_p = pred_[2].data();
+	arrays.yaw_p = pred_[3].data();
+	arrays.yawd_p = pred_[4].data();
+	arrays.sin_yaw = trig_[0].data();
+	arrays.cos_yaw = trig_[1].data();
+	arrays.sin_yaw_t = trig_[2].data();
+	arrays.cos_yaw_t = trig_[3].data();
+	predictSigmaPoints(arrays, size_ * dim_sig_, straight_ * dim_sig_,
+		delta_t);
+}
+
+void SigmaPointBatch::advance(){
+
+	const int n = size_ * dim_sig_;
+	for(int c = 0; c < dim_x_; ++c)
+		aug_[c].head(n) = pred_[c].head(n);
+}
+
+void SigmaPointBatch::computeMean(){
+
+	// Predicted state mean, one weighted sum per entry
+	for(int c = 0; c < dim_x_; ++c){
+		Map<const MatrixXd> sigma(pred_[c].data(), dim_sig_, size_);
+		Map<RowVectorXd> mean(mean_[c].data(), size_);
+		mean.noalias() = weights_.transpose() * sigma;
+	}
+}
+
+void SigmaPointBatch::computeMoments(){
+
+	computeMean();
+
+	// Predicted state covariance in blocks of entries
+	MatrixXd & product = diff_[dim_x_];
+	for(int b = 0; b < size_; b += BLOCK_SIZE){
+
+		int m = std::min(BLOCK_SIZE, size_ - b);
+
+		// State differences
+		for(int c = 0; c < dim_x_; ++c){
+			Map<const MatrixXd> sigma(pred_[c].data() + b * dim_sig_,
+				dim_sig_, m);
+			diff_[c].leftCols(m) = sigma.rowwise() -
+				mean_[c].segment(b, m).matrix().transpose();
+		}
+
+		// Angle normalization
+		for(int i = 0; i < m * dim_sig_; ++i)
+			diff_[3](i) = Filter::normalizeAngle(diff_[3](i));
+
+		// Weighted products of all component pairs, the yaw rate of constant
+		// velocity entries has no spread
+		bool straight = b + m <= straight_;
+		int index = 0;
+		for(int r = 0; r < dim_x_; ++r){
+			for(int c = r; c < dim_x_; ++c){
+				if(straight && c == 4){
+					cov_[index].segment(b, m).setZero();
+					index++;
+					continue;
+				}
+				product.leftCols(m) =
+					diff_[r].leftCols(m).cwiseProduct(diff_[c].leftCols(m));
+				Map<RowVectorXd> cov(cov_[index].data() + b, m);
+				cov.noalias() = weights_.transpose() * product.leftCols(m);
+				index++;
+			}
+		}
+	}
+}
+
+void SigmaPointBatch::getSigmaPoints(const int k,
+	Filter::SigmaMatrix & Xsig_pred) const{
+
+	Xsig_pred.resize(dim_x_, dim_sig_);
+	for(int c = 0; c < dim_x_; ++c)
+		Xsig_pred.row(c) = pred_[c].segment(k * dim_sig_, dim_sig_).matrix();
+}
+
+void SigmaPointBatch::getState(const int k, Filter::StateVector & x,
+	Filter::StateMatrix & P) const{
+
+	x.resize(dim_x_);
+	P.resize(dim_x_, dim_x_);
+	int index = 0;
+	for(int r = 0; r < dim_x_; ++r){
+		x(r) = mean_[r](k);
+		for(int c = r; c < dim_x_; ++c){
+			P(r,c) = cov_[index](k);
+			P(c,r) = cov_[index](k);
+			index++;
+		}
+	}
+}
+
+void SigmaPointBatch::getMean(const int k, Filter::StateVector & x) const{
+
+	x.resize(dim_x_);
+	for(int r = 0; r < dim_x_; ++r)
+		x(r) = mean_[r](k);
+}
+
+void SigmaPointBatch::getPositionCovariance(const int k, Matrix2d & P) const{
+
+	// Weighted products of the position deviations of one entry
+	P.setZero();
+	int offset = k * dim_sig_;
+	for(int j = 0; j < dim_sig_; ++j){
+		double dx = pred_[0](offset + j) - mean_[0](k);
+		double dy = pred_[1](offset + j) - mean_[1](k);
+		P(0,0) += weights_(j) * dx * dx;
+		P(0,1) += weights_(j) * dx * dy;
+		P(1,1) += weights_(j) * dy * dy;
+	}
+	P(1,0) = P(0,1);
+}
+
+} // namespace tracking
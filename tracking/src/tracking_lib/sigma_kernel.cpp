@@ -0,0 +1,79 @@
+#include <tracking_lib/sigma_kernel.h>
+#include <cmath>
+
+namespace tracking{
+
+void predictSigmaPoints(const SigmaKernelArrays & arrays, const int n,
+	const int n_straight, const double delta_t){
+
+	// Grab arrays for better readability
+	const double * p_x = arrays.p_x;
+	const double * p_y = arrays.p_y;
+	const double * v = arrays.v;
+	const double * yaw = arrays.yaw;
+	const double * yawd = arrays.yawd;
+	const double * nu_a = arrays.nu_a;
+	const double * nu_yawdd = arrays.nu_yawdd;
+	double * px_p = arrays.px_p;
+	double * py_p = arrays.py_p;
+	double * v_p = arrays.v_p;
+	double * yaw_p = arrays.yaw_p;
+	double * yawd_p = arrays.yawd_p;
+	double * sin_yaw = arrays.sin_yaw;
+	double * cos_yaw = arrays.cos_yaw;
+	double * sin_yaw_t = arrays.sin_yaw_t;
+	double * cos_yaw_t = arrays.cos_yaw_t;
+	const double half_dt2 = 0.5 * delta_t * delta_t;
+
+	// Predicted yaw
+	#pragma omp simd
+	for(int i = 0; i < n; ++i)
+		yaw_p[i] = yaw[i] + yawd[i] * delta_t;
+
+	// One loop per function so that each maps onto a vector sin or cos, the
+	// yaw of leading constant velocity entries does not change
+	#pragma omp simd
+	for(int i = 0; i < n; ++i)
+		sin_yaw[i] = std::sin(yaw[i]);
+	#pragma omp simd
+	for(int i = 0; i < n; ++i)
+		cos_yaw[i] = std::cos(yaw[i]);
+	#pragma omp simd
+	for(int i = n_straight; i < n; ++i)
+		sin_yaw_t[i] = std::sin(yaw_p[i]);
+	#pragma omp simd
+	for(int i = n_straight; i < n; ++i)
+		cos_yaw_t[i] = std::cos(yaw_p[i]);
+
+	// Constant velocity model of the leading entries
+	#pragma omp simd
+	for(int i = 0; i < n_straight; ++i){
+		double dist = v[i] * delta_t + half_dt2 * nu_a[i];
+		px_p[i] = p_x[i] + dist * cos_yaw[i];
+		py_p[i] = p_y[i] + dist * sin_yaw[i];
+		v_p[i] = v[i] + nu_a[i] * delta_t;
+		yawd_p[i] = 0.0;
+	}
+
+	// Branch free CTRV model over all other entries and sigma points
+	#pragma omp simd
+	for(int i = n_straight; i < n; ++i){
+
+		// Avoid division by zero
+		bool turning = std::fabs(yawd[i]) > 0.001;
+		double v_yawd = v[i] / (turning ? yawd[i] : 1.0);
+		double dx = turning ? v_yawd * (sin_yaw_t[i] - sin_yaw[i]) :
+			v[i] * delta_t * cos_yaw[i];
+		double dy = turning ? v_yawd * (cos_yaw[i] - cos_yaw_t[i]) :
+			v[i] * delta_t * sin_yaw[i];
+
+		// Predicted state with noise
+		px_p[i] = p_x[i] + dx + half_dt2 * nu_a[i] * cos_yaw[i];
+		py_p[i] = p_y[i] + dy + half_dt2 * nu_a[i] * sin_yaw[i];
+		v_p[i] = v[i] + nu_a[i] * delta_t;
+		yaw_p[i] += half_dt2 * nu_yawdd[i];
+		yawd_p[i] = yawd[i] + nu_yawdd[i] * delta_t;
+	}
+}
+
+} // namespace tracking
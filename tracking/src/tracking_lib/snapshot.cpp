@@ -0,0 +1,102 @@
+#include <tracking_lib/snapshot.h>
+#include <ros/console.h>
+#include <cstdio>
+#include <fstream>
+
+namespace tracking{
+
+/******************************************************************************/
+
+SnapshotWriter::SnapshotWriter():
+	running_(false),
+	stop_(false),
+	has_pending_(false)
+	{
+}
+
+SnapshotWriter::~SnapshotWriter(){
+
+	stop();
+}
+
+void SnapshotWriter::start(const std::string & filename){
+
+	stop();
+	filename_ = filename;
+	stop_ = false;
+	has_pending_ = false;
+	running_ = true;
+	thread_ = std::thread(&SnapshotWriter::run, this);
+}
+
+void SnapshotWriter::stop(){
+
+	if(!running_)
+		return;
+
+	// Wake up the writer, it finishes the waiting snapshot first
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	wake_.notify_one();
+	thread_.join();
+	running_ = false;
+}
+
+void SnapshotWriter::write(std::vector<char> & buffer){
+
+	if(!running_)
+		return;
+
+	// Replace a snapshot that was not written yet
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		pending_.swap(buffer);
+		has_pending_ = true;
+	}
+	wake_.notify_one();
+	buffer.clear();
+}
+
+bool SnapshotWriter::read(const std::string & filename,
+	std::vector<char> & buffer){
+
+	std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+	if(!file)
+		return false;
+
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	buffer.resize(size);
+	return size == 0 || bool(file.read(buffer.data(), size));
+}
+
+void SnapshotWriter::run(){
+
+	std::vector<char> buffer;
+	std::string temporary = filename_ + ".tmp";
+	while(true){
+
+		// Wait for a snapshot
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wake_.wait(lock, [this]{ return stop_ || has_pending_; });
+			if(!has_pending_)
+				return;
+			buffer.swap(pending_);
+			has_pending_ = false;
+		}
+
+		// Write completely, then replace the previous snapshot
+		std::ofstream file(temporary.c_str(),
+			std::ios::binary | std::ios::trunc);
+		file.write(buffer.data(), buffer.size());
+		file.close();
+		if(!file || std::rename(temporary.c_str(), filename_.c_str()) != 0)
+			ROS_WARN("Could not write tracking snapshot [%s]",
+				filename_.c_str());
+	}
+}
+
+} // namespace tracking
@@ -0,0 +1,108 @@
+#include <tracking_lib/spatial_hash.h>
+#include <cmath>
+
+namespace tracking{
+
+/******************************************************************************/
+
+SpatialHash::SpatialHash():
+	cell_size_(1.0),
+	mask_(0)
+	{
+}
+
+SpatialHash::~SpatialHash(){
+
+}
+
+void SpatialHash::clear(const float cell_size){
+
+	cell_size_ = cell_size;
+	points_.clear();
+	sorted_.clear();
+	bucket_begin_.assign(2, 0);
+	mask_ = 0;
+}
+
+int SpatialHash::size() const{
+
+	return points_.size();
+}
+
+int SpatialHash::toCell(const float value) const{
+
+	return int(std::floor(value / cell_size_));
+}
+
+unsigned int SpatialHash::toBucket(const int cell_x, const int cell_y) const{
+
+	return ((unsigned int)(cell_x) * 73856093u ^
+		(unsigned int)(cell_y) * 19349663u) & mask_;
+}
+
+void SpatialHash::add(const float x, const float y, const int index){
+
+	Entry entry;
+	entry.cell_x = toCell(x);
+	entry.cell_y = toCell(y);
+	entry.x = x;
+	entry.y = y;
+	entry.index = index;
+	points_.push_back(entry);
+}
+
+void SpatialHash::build(){
+
+	// At least twice as many buckets as points
+	unsigned int buckets = 1;
+	while(buckets < 2 * points_.size())
+		buckets <<= 1;
+	mask_ = buckets - 1;
+
+	// Count points per bucket
+	bucket_begin_.assign(buckets + 1, 0);
+	for(int i = 0; i < points_.size(); ++i)
+		bucket_begin_[toBucket(points_[i].cell_x, points_[i].cell_y) + 1]++;
+	for(int b = 0; b < buckets; ++b)
+		bucket_begin_[b + 1] += bucket_begin_[b];
+
+	// Stable scatter into buckets
+	sorted_.resize(points_.size());
+	std::vector<int> fill(bucket_begin_.begin(), bucket_begin_.end() - 1);
+	for(int i = 0; i < points_.size(); ++i){
+		unsigned int b = toBucket(points_[i].cell_x, points_[i].cell_y);
+		sorted_[fill[b]++] = points_[i];
+	}
+}
+
+void SpatialHash::query(const float x, const float y, const float radius,
+	std::vector<int> & indices) const{
+
+	indices.clear();
+	if(points_.empty())
+		return;
+
+	// Cells covering the query box
+	int x_min = toCell(x - radius);
+	int x_max = toCell(x + radius);
+	int y_min = toCell(y - radius);
+	int y_max = toCell(y + radius);
+
+	for(int cx = x_min; cx <= x_max; ++cx){
+		for(int cy = y_min; cy <= y_max; ++cy){
+
+			// Skip points of other cells sharing the bucket
+			unsigned int b = toBucket(cx, cy);
+			for(int k = bucket_begin_[b]; k < bucket_begin_[b + 1]; ++k){
+				const Entry & entry = sorted_[k];
+				if(entry.cell_x != cx || entry.cell_y != cy)
+					continue;
+				if(std::fabs(entry.x - x) <= radius &&
+					std::fabs(entry.y - y) <= radius)
+					indices.push_back(entry.index);
+			}
+		}
+	}
+}
+
+} // namespace tracking
@@ -0,0 +1,102 @@
+#include <tracking_lib/thread_pool.h>
+#include <algorithm>
+
+namespace tracking{
+
+/******************************************************************************/
+
+ThreadPool::ThreadPool():
+	task_(NULL),
+	n_(0),
+	chunk_(0),
+	generation_(0),
+	pending_(0),
+	stop_(false)
+	{
+}
+
+ThreadPool::~ThreadPool(){
+
+	// Wake up and join all workers
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	start_.notify_all();
+	for(int i = 0; i < workers_.size(); ++i)
+		workers_[i].join();
+}
+
+void ThreadPool::init(const int num_threads){
+
+	for(int w = workers_.size() + 1; w < num_threads; ++w)
+		workers_.push_back(std::thread(&ThreadPool::run, this, w));
+}
+
+int ThreadPool::size() const{
+
+	return workers_.size() + 1;
+}
+
+void ThreadPool::parallelFor(const int n, const int grain, const Task & task){
+
+	// Shard size as multiple of grain
+	int workers = size();
+	int chunk = (n + workers - 1) / workers;
+	chunk = std::max(grain, (chunk + grain - 1) / grain * grain);
+
+	// Small ranges run in the calling thread
+	if(workers == 1 || n <= chunk){
+		if(n > 0)
+			task(0, 0, n);
+		return;
+	}
+
+	// Publish task to workers
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		task_ = &task;
+		n_ = n;
+		chunk_ = chunk;
+		pending_ = workers_.size();
+		generation_++;
+	}
+	start_.notify_all();
+
+	// Calling thread takes the first shard
+	task(0, 0, chunk);
+
+	// Wait for the other shards
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_.wait(lock, [this]{ return pending_ == 0; });
+	task_ = NULL;
+}
+
+void ThreadPool::run(const int worker){
+
+	int generation = 0;
+	while(true){
+
+		// Wait for a new task
+		std::unique_lock<std::mutex> lock(mutex_);
+		start_.wait(lock, [&]{ return stop_ || generation_ != generation; });
+		if(stop_)
+			return;
+		generation = generation_;
+		const Task * task = task_;
+		int begin = worker * chunk_;
+		int end = std::min(n_, begin + chunk_);
+		lock.unlock();
+
+		// Process shard
+		if(begin < end)
+			(*task)(worker, begin, end);
+
+		// Report completion
+		lock.lock();
+		if(--pending_ == 0)
+			done_.notify_one();
+	}
+}
+
+} // namespace tracking
@@ -0,0 +1,1116 @@
+/******************************************************************************
+ *
+ * Author: Simon Appel (simonappel62@gmail.com)
+ * Date: 25/04/2018
+ *
+ */
+
+#include <tracking_lib/tracker.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace tracking{
+
+// Tracks per shard grain, equal to the block size of the batched reductions so
+// that parallel and serial prediction produce identical results
+static const int TRACK_GRAIN = 64;
+
+// Snapshot file identification
+static const int SNAPSHOT_MAGIC = 0x534b5254;
+static const int SNAPSHOT_VERSION = 2;
+
+/******************************************************************************/
+
+Tracker::Tracker():
+	is_initialized_(false),
+	track_id_counter_(0),
+	last_time_stamp_(0.0),
+	history_begin_(0),
+	history_size_(0),
+	evicted_time_stamp_(0.0),
+	replay_stats_(),
+	stage_times_()
+	{
+}
+
+Tracker::~Tracker(){
+
+}
+
+void Tracker::init(const Parameter & params){
+
+	params_ = params;
+
+	// Set initialized to false at the beginning
+	is_initialized_ = false;
+
+	// Fixed size filter dimensions override the configured ones
+	if(Filter::DimX != Dynamic && (params_.tra_dim_x != Filter::DimX ||
+		params_.tra_dim_x_aug != Filter::DimXAug ||
+		params_.tra_dim_z != Filter::DimZ)){
+		ROS_WARN("Tracking dimensions [%d,%d,%d] differ from the compiled"
+			" filter, using [%d,%d,%d]", params_.tra_dim_x,
+			params_.tra_dim_x_aug, params_.tra_dim_z, int(Filter::DimX),
+			int(Filter::DimXAug), int(Filter::DimZ));
+		params_.tra_dim_x = Filter::DimX;
+		params_.tra_dim_x_aug = Filter::DimXAug;
+		params_.tra_dim_z = Filter::DimZ;
+	}
+
+	// Define weights and measurement covariance of the UKF
+	filter_.init(params_.tra_dim_x, params_.tra_dim_x_aug, params_.tra_dim_z,
+		params_.tra_lambda, params_.tra_std_acc, params_.tra_std_yaw_rate,
+		params_.tra_std_lidar_x, params_.tra_std_lidar_y);
+
+	// Interacting models predict with the batch and update linearly, both
+	// probabilities stay inside (0,1) so every model keeps some weight
+	const float p_min = 1e-3f;
+	const float p_max = 1.0f - p_min;
+	if(!(params_.tra_imm_p_stay >= p_min && params_.tra_imm_p_stay <= p_max) ||
+		!(params_.tra_imm_mu_cv >= p_min && params_.tra_imm_mu_cv <= p_max)){
+		ROS_WARN("IMM probabilities [%f,%f] outside of (0,1), clamped",
+			params_.tra_imm_p_stay, params_.tra_imm_mu_cv);
+		params_.tra_imm_p_stay = params_.tra_imm_p_stay > p_min ?
+			std::min(params_.tra_imm_p_stay, p_max) : p_min;
+		params_.tra_imm_mu_cv = params_.tra_imm_mu_cv > p_min ?
+			std::min(params_.tra_imm_mu_cv, p_max) : p_min;
+	}
+	imm_.init(params_.tra_imm_p_stay);
+	if(params_.tra_imm && params_.tra_square_root){
+		ROS_WARN("Square root filter is not available with IMM, disabled");
+		params_.tra_square_root = false;
+	}
+
+	// Workers with one prediction batch each
+	pool_.init(params_.tra_threads);
+	batches_.resize(pool_.size());
+	for(int i = 0; i < batches_.size(); ++i)
+		batches_[i].init(filter_);
+	query_batch_.init(filter_);
+
+	// Start ids for track with 0
+	tracks_.clear();
+	trajectories_.init(params_.tra_trajectory_length);
+	track_id_counter_ = 0;
+
+	// Random color for track
+	rng_(2345);
+
+	// Recorded frames for out of sequence frames
+	history_.resize(std::max(0, params_.tra_history_depth));
+	history_begin_ = 0;
+	history_size_ = 0;
+	evicted_time_stamp_ = -std::numeric_limits<double>::infinity();
+	replay_stats_ = ReplayStatistics();
+	stage_times_ = StageTimes();
+}
+
+void Tracker::process(const ObjectArray & detected_objects){
+
+	// Frames older than the last one need a rollback
+	if(is_initialized_ &&
+		detected_objects.header.stamp.toSec() < last_time_stamp_){
+		processLate(detected_objects);
+		return;
+	}
+
+	recordFrame(detected_objects);
+	processFrame(detected_objects);
+}
+
+void Tracker::processLate(const ObjectArray & detected_objects){
+
+	double time_stamp = detected_objects.header.stamp.toSec();
+	std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+
+	// First recorded frame after the late one
+	int k = history_size_;
+	while(k > 0 && recordAt(k - 1).frame.header.stamp.toSec() > time_stamp)
+		k--;
+
+	// The state before the late frame must still be recorded
+	if(history_size_ == 0 || (k == 0 && time_stamp < evicted_time_stamp_)){
+		ROS_WARN("Dropping frame [%f] s older than the last one, beyond the"
+			" history of [%d] frames", last_time_stamp_ - time_stamp,
+			int(history_.size()));
+		replay_stats_.dropped_frames++;
+		return;
+	}
+
+	// Late frame and all later frames in order
+	int depth = history_size_ - k;
+	replay_frames_.resize(depth + 1);
+	replay_frames_[0] = detected_objects;
+	for(int j = k; j < history_size_; ++j)
+		replay_frames_[j - k + 1] = recordAt(j).frame;
+
+	// Roll back and replay, recording the frames again
+	restoreCheckpoint(recordAt(k).before);
+	history_size_ = k;
+	for(int j = 0; j < replay_frames_.size(); ++j){
+		recordFrame(replay_frames_[j]);
+		processFrame(replay_frames_[j]);
+	}
+
+	// Statistics
+	double time = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+	replay_stats_.late_frames++;
+	replay_stats_.last_depth = depth;
+	replay_stats_.max_depth = std::max(replay_stats_.max_depth, depth);
+	replay_stats_.last_time = time;
+	replay_stats_.total_time += time;
+	ROS_INFO("Late frame [%f] s: rolled back [%d] frames, replay took [%f] ms",
+		last_time_stamp_ - time_stamp, depth, time);
+}
+
+FrameRecord & Tracker::recordAt(const int k){
+
+	return history_[(history_begin_ + k) % history_.size()];
+}
+
+void Tracker::recordFrame(const ObjectArray & detected_objects){
+
+	if(history_.empty())
+		return;
+
+	// Oldest frame drops out, its slot is reused
+	if(history_size_ == history_.size()){
+		evicted_time_stamp_ = recordAt(0).frame.header.stamp.toSec();
+		history_begin_ = (history_begin_ + 1) % history_.size();
+		history_size_--;
+	}
+
+	FrameRecord & record = recordAt(history_size_);
+	saveCheckpoint(record.before);
+	record.frame = detected_objects;
+	history_size_++;
+}
+
+void Tracker::saveCheckpoint(Checkpoint & checkpoint) const{
+
+	checkpoint.tracks = tracks_;
+	checkpoint.trajectories = trajectories_;
+	checkpoint.track_id_counter = track_id_counter_;
+	checkpoint.rng_state = rng_.state;
+	checkpoint.time_stamp = last_time_stamp_;
+	checkpoint.is_initialized = is_initialized_;
+}
+
+void Tracker::restoreCheckpoint(const Checkpoint & checkpoint){
+
+	tracks_ = checkpoint.tracks;
+	trajectories_ = checkpoint.trajectories;
+	track_id_counter_ = checkpoint.track_id_counter;
+	rng_.state = checkpoint.rng_state;
+	last_time_stamp_ = checkpoint.time_stamp;
+	is_initialized_ = checkpoint.is_initialized;
+}
+
+void Tracker::processFrame(const ObjectArray & detected_objects){
+
+	// Read current time
+	double time_stamp = detected_objects.header.stamp.toSec();
+
+	// All other frames
+	if(is_initialized_){
+
+		// Calculate time difference between frames
+		double delta_t = time_stamp - last_time_stamp_;
+		std::chrono::steady_clock::time_point t0 =
+			std::chrono::steady_clock::now();
+
+		// Prediction, predicted measurements for gating and update
+		Prediction(delta_t);
+		PredictMeasurements();
+		std::chrono::steady_clock::time_point t1 =
+			std::chrono::steady_clock::now();
+
+		// Data association
+		GlobalNearestNeighbor(detected_objects);
+		std::chrono::steady_clock::time_point t2 =
+			std::chrono::steady_clock::now();
+
+		// Update
+		Update(detected_objects);
+		std::chrono::steady_clock::time_point t3 =
+			std::chrono::steady_clock::now();
+
+		// Track management
+		TrackManagement(detected_objects);
+		std::chrono::steady_clock::time_point t4 =
+			std::chrono::steady_clock::now();
+
+		// Profiling
+		typedef std::chrono::duration<double, std::milli> Milliseconds;
+		stage_times_.frames++;
+		stage_times_.prediction += Milliseconds(t1 - t0).count();
+		stage_times_.association += Milliseconds(t2 - t1).count();
+		stage_times_.update += Milliseconds(t3 - t2).count();
+		stage_times_.management += Milliseconds(t4 - t3).count();
+
+	}
+	// First frame
+	else{
+
+		// Initialize tracks
+		for(int i = 0; i < detected_objects.list.size(); ++i){
+			initTrack(detected_objects.list[i]);
+		}
+
+		// Set initialized to true
+		is_initialized_ = true;
+	}
+
+	// Store time stamp for next frame
+	last_time_stamp_ = time_stamp;
+
+	// Append the state of this frame to the trajectories
+	recordTrajectories(time_stamp);
+}
+
+void Tracker::recordTrajectories(const double time_stamp){
+
+	TrajectoryPoint point;
+	point.stamp = time_stamp;
+	for(int i = 0; i < tracks_.size(); ++i){
+		const State & sta = tracks_[i].sta;
+		point.x = sta.x[0];
+		point.y = sta.x[1];
+		point.v = sta.x[2];
+		point.yaw = sta.x[3];
+		trajectories_.push(tracks_.handle(i).index, point);
+	}
+}
+
+void Tracker::Prediction(const double delta_t){
+
+	// Tracks are independent, shards are a multiple of the batch block size
+	pool_.parallelFor(tracks_.size(), TRACK_GRAIN,
+		[&](const int worker, const int begin, const int end){
+
+		// Mix the models of each track and predict both in one kernel
+		if(params_.tra_imm){
+
+			for(int i = begin; i < end; ++i)
+				imm_.mix(tracks_[i].models);
+
+			// Constant velocity entries of all tracks first, so that they
+			// skip the turning part of the kernel
+			SigmaPointBatch & batch = batches_[worker];
+			batch.clear();
+			for(int m = 0; m < NUM_MODELS; ++m){
+				for(int i = begin; i < end; ++i){
+					ModelSet & models = tracks_[i].models;
+					batch.add(models.x[m], models.P[m], MotionModel(m));
+				}
+			}
+
+			batch.predict(delta_t);
+			batch.computeMoments();
+
+			// Sigma points are not kept, the models update linearly
+			for(int i = begin; i < end; ++i){
+				Track & track = tracks_[i];
+				for(int m = 0; m < NUM_MODELS; ++m){
+					int entry = m * (end - begin) + i - begin;
+					batch.getState(entry, track.models.x[m], track.models.P[m]);
+				}
+				imm_.combine(track.models, track.sta.x, track.sta.P);
+			}
+			return;
+		}
+
+		// Square root filter carries the covariance factor between frames
+		if(params_.tra_square_root){
+			for(int i = begin; i < end; ++i){
+				State & sta = tracks_[i].sta;
+				filter_.predictSqrt(sta.x, sta.L, sta.Xsig_pred, delta_t);
+				sta.P.noalias() = sta.L * sta.L.transpose();
+			}
+			return;
+		}
+
+		// Predict the sigma points of all tracks of the shard in one kernel
+		if(params_.tra_batch_prediction){
+
+			SigmaPointBatch & batch = batches_[worker];
+			batch.clear();
+			for(int i = begin; i < end; ++i)
+				batch.add(tracks_[i].sta.x, tracks_[i].sta.P);
+
+			batch.predict(delta_t);
+			batch.computeMoments();
+
+			for(int i = begin; i < end; ++i){
+				batch.getSigmaPoints(i - begin, tracks_[i].sta.Xsig_pred);
+				batch.getState(i - begin, tracks_[i].sta.x, tracks_[i].sta.P);
+			}
+			return;
+		}
+
+		// Loop through shard of tracks
+		for(int i = begin; i < end; ++i){
+
+			// Grab track
+			Track & track = tracks_[i];
+
+			// Predict sigma points, state vector and state covariance
+			filter_.predict(track.sta.x, track.sta.P, track.sta.Xsig_pred,
+				delta_t);
+
+			/*
+			// Print prediction
+			ROS_INFO("Pred of T[%d] xp=[%f,%f,%f,%f,%f], Pp=[%f,%f,%f,%f,%f]",
+				track.id, track.sta.x(0), track.sta.x(1), track.sta.x(2), 
+				track.sta.x(3), track.sta.x(4),	track.sta.P(0), track.sta.P(6), 
+				track.sta.P(12), track.sta.P(18), track.sta.P(24)
+			);
+			*/
+		}
+	});
+}
+
+void Tracker::PredictMeasurements(){
+
+	// Innovation of every track once per frame, shared by association and
+	// update
+	const double gate_var =
+		params_.da_mahalanobis_std * params_.da_mahalanobis_std;
+	pool_.parallelFor(tracks_.size(), TRACK_GRAIN,
+		[&](const int worker, const int begin, const int end){
+
+		for(int i = begin; i < end; ++i){
+
+			State & sta = tracks_[i].sta;
+			if(params_.tra_imm){
+				ModelSet & models = tracks_[i].models;
+				for(int m = 0; m < NUM_MODELS; ++m){
+					filter_.predictMeasurement(models.x[m], models.P[m],
+						models.inn[m]);
+				}
+				filter_.predictMeasurement(sta.x, sta.P, sta.inn);
+			}
+			else if(params_.tra_square_root || params_.tra_linear_update){
+				filter_.predictMeasurement(sta.x, sta.P, sta.inn);
+			}
+			else{
+				filter_.predictMeasurement(sta.x, sta.P, sta.Xsig_pred, sta.inn);
+			}
+
+			// Innovation covariance widened by maneuvers the motion model
+			// misses, the filter alone is too confident for the gate
+			if(params_.da_mahalanobis){
+				sta.gate_S = sta.inn.S + gate_var *
+					Filter::MeasurementMatrix::Identity(params_.tra_dim_z,
+					params_.tra_dim_z);
+				sta.gate_S_inv = filter_.invertInnovation(sta.gate_S);
+			}
+		}
+	});
+}
+
+void Tracker::GlobalNearestNeighbor(
+	const ObjectArray & detected_objects){
+
+	// Gated candidates, detected objects within the position gate of a track
+	// and the miss cost of each track
+	std::vector<Candidate> candidates;
+	std::vector<Candidate> in_gate;
+	std::vector<float> miss_costs(tracks_.size(), 0.0);
+
+	// Index detected objects per class on a grid of the class position gate
+	ped_index_.clear(params_.da_ped_dist_pos);
+	car_index_.clear(params_.da_car_dist_pos);
+	for(int j = 0; j < detected_objects.list.size(); ++j){
+		const Object & obj = detected_objects.list[j];
+		if(obj.semantic_id == 11)
+			ped_index_.add(obj.world_pose.point.x, obj.world_pose.point.y, j);
+		else if(obj.semantic_id == 13)
+			car_index_.add(obj.world_pose.point.x, obj.world_pose.point.y, j);
+	}
+	ped_index_.build();
+	car_index_.build();
+
+	// Loop through tracks
+	for(int i = 0; i < tracks_.size(); ++i){
+
+		// Set data association parameters depending on if 
+		// the track is a car or a pedestrian
+		float gate;
+		float box_gate;
+		const SpatialHash * index;
+
+		// Pedestrian
+		if(tracks_[i].sem.id == 11){
+			gate = params_.da_ped_dist_pos;
+			box_gate = params_.da_ped_dist_form;
+			index = &ped_index_;
+		}
+		// Car
+		else if(tracks_[i].sem.id == 13){
+			gate = params_.da_car_dist_pos;
+			box_gate = params_.da_car_dist_form;
+			index = &car_index_;
+		}
+		else{
+			ROS_WARN("Wrong semantic for track [%d]", tracks_[i].id);
+			continue;
+		}
+
+		// Gate on the Mahalanobis distance of the predicted measurement, the
+		// search radius is the major half axis of the gate ellipse
+		if(params_.da_mahalanobis){
+
+			// Widened innovation covariance from PredictMeasurements
+			const State & sta = tracks_[i].sta;
+			const Filter::MeasurementMatrix & S = sta.gate_S;
+			double half_trace = 0.5 * (S(0,0) + S(1,1));
+			double det = S(0,0) * S(1,1) - S(0,1) * S(1,0);
+			double lambda_max = half_trace +
+				std::sqrt(std::max(0.0, half_trace * half_trace - det));
+			float radius = std::sqrt(params_.da_mahalanobis_gate * lambda_max);
+
+			// Staying unassigned costs as much as the worst accepted match
+			miss_costs[i] = std::sqrt(params_.da_mahalanobis_gate) + box_gate;
+
+			index->query(sta.inn.z_pred(0), sta.inn.z_pred(1), radius,
+				gate_indices_);
+			for(int k = 0; k < gate_indices_.size(); ++k){
+
+				int j = gate_indices_[k];
+				const Object & obj = detected_objects.list[j];
+				Filter::MeasurementVector z_diff =
+					Filter::MeasurementVector::Zero(params_.tra_dim_z);
+				z_diff << obj.world_pose.point.x, obj.world_pose.point.y;
+				z_diff -= sta.inn.z_pred;
+				double dist = z_diff.dot(sta.gate_S_inv * z_diff);
+
+				if(dist < params_.da_mahalanobis_gate){
+					float box_mismatch = CalculateBoxMismatch(tracks_[i], obj);
+					Candidate cand;
+					cand.track = i;
+					cand.object = j;
+					cand.cost = std::sqrt(dist) + box_mismatch;
+					in_gate.push_back(cand);
+					if(box_mismatch < box_gate)
+						candidates.push_back(cand);
+				}
+			}
+			continue;
+		}
+
+		// Staying unassigned costs as much as the worst accepted match
+		miss_costs[i] = box_gate;
+
+		// Loop through detected objects of the same class near the track
+		index->query(tracks_[i].sta.x(0), tracks_[i].sta.x(1), gate,
+			gate_indices_);
+		for(int k = 0; k < gate_indices_.size(); ++k){
+
+			// Calculate distance between track and detected object
+			int j = gate_indices_[k];
+			float dist = CalculateDistance(tracks_[i], 
+				detected_objects.list[j]);
+
+			if(dist < gate){
+				Candidate cand;
+				cand.track = i;
+				cand.object = j;
+				cand.cost = CalculateEuclideanAndBoxOffset(tracks_[i],
+					detected_objects.list[j]);
+				in_gate.push_back(cand);
+				if(cand.cost < box_gate)
+					candidates.push_back(cand);
+			}
+		}
+	}
+
+	// Minimum total box distance over all tracks
+	assignment_.solve(tracks_.size(), detected_objects.list.size(),
+		candidates, miss_costs, pool_, da_tracks, da_objects);
+
+	// Block unassigned measurements near an assigned track to NOT be
+	// initialized
+	for(int k = 0; k < in_gate.size(); ++k){
+		const Candidate & cand = in_gate[k];
+		if(da_tracks[cand.track] >= 0 && da_objects[cand.object] == -1)
+			da_objects[cand.object] = -2;
+	}
+
+	for(int i = 0; i < tracks_.size(); ++i){
+		if(da_tracks[i] == -1)
+			ROS_WARN("No measurement found for track [%d]", tracks_[i].id);
+	}
+}
+
+float Tracker::CalculateDistance(const Track & track,
+	const Object & object){
+
+	// Calculate euclidean distance in x,y,z coordinates of track and object
+	return abs(track.sta.x(0) - object.world_pose.point.x) + 
+		abs(track.sta.x(1) - object.world_pose.point.y) + 
+		abs(track.sta.z - object.world_pose.point.z);
+}
+
+float Tracker::CalculateBoxMismatch(const Track & track,
+	const Object & object){
+
+	// Calculate mismatch of both tracked cube and detected cube
+	float box_wl_switched =  abs(track.geo.width - object.length) + 
+		abs(track.geo.length - object.width);
+	float box_wl_ordered = abs(track.geo.width - object.width) + 
+		abs(track.geo.length - object.length);
+	float box_mismatch = (box_wl_switched < box_wl_ordered) ? 
+		box_wl_switched : box_wl_ordered;
+	box_mismatch += abs(track.geo.height - object.height);
+	return box_mismatch;
+}
+
+float Tracker::CalculateEuclideanAndBoxOffset(const Track & track,
+	const Object & object){
+
+	// Sum of euclidean offset and box mismatch
+	return CalculateDistance(track, object) + 
+		CalculateBoxMismatch(track, object);
+}
+
+void Tracker::Update(const ObjectArray & detected_objects){
+
+	// Tracks are independent given the data association
+	pool_.parallelFor(tracks_.size(), 1,
+		[&](const int worker, const int begin, const int end){
+
+		// Loop through shard of tracks
+		for(int i = begin; i < end; ++i){
+
+			// Grab track
+			Track & track = tracks_[i];
+
+			// If track has not found any measurement
+			if(da_tracks[i] == -1){
+
+				// Increment bad aging
+				track.hist.bad_age++;
+			}
+			// If track has found a measurement update it
+			else{
+
+				// Grab measurement
+				Filter::MeasurementVector z = 
+					Filter::MeasurementVector::Zero(params_.tra_dim_z);
+				z << detected_objects.list[ da_tracks[i] ].world_pose.point.x, 
+					 detected_objects.list[ da_tracks[i] ].world_pose.point.y;
+
+/******************************************************************************
+ * 1. Update state vector and covariance matrix
+ */
+				// Innovations were predicted with the measurement model of
+				// the configured update
+				if(params_.tra_imm){
+					double likelihood[NUM_MODELS];
+					for(int m = 0; m < NUM_MODELS; ++m){
+						likelihood[m] = filter_.update(track.models.x[m],
+							track.models.P[m], track.models.inn[m], z);
+					}
+					imm_.update(track.models, likelihood);
+					imm_.combine(track.models, track.sta.x, track.sta.P);
+				}
+				else if(params_.tra_square_root){
+					filter_.updateSqrt(track.sta.x, track.sta.L, track.sta.inn,
+						z);
+					track.sta.P.noalias() = track.sta.L * track.sta.L.transpose();
+				}
+				else{
+					filter_.update(track.sta.x, track.sta.P, track.sta.inn, z);
+				}
+
+				// Update History
+				track.hist.good_age++;
+				track.hist.bad_age = 0;
+
+/******************************************************************************
+ * 2. Update geometric information of track
+ */
+				// Calculate area of detection and track
+				float det_area = 
+					detected_objects.list[ da_tracks[i] ].length *
+					detected_objects.list[ da_tracks[i] ].width;
+				float tra_area = track.geo.length * track.geo.width;
+
+				// If track became strongly smaller keep the shape
+				if(params_.tra_occ_factor * det_area < tra_area){
+					ROS_WARN("Track [%d] probably occluded because of dropping size"
+						" from [%f] to [%f]", track.id, tra_area, det_area);
+				}
+				// Else update the form of the track with measurement
+				else{
+					track.geo.length = 
+						detected_objects.list[ da_tracks[i] ].length;
+					track.geo.width = 
+						detected_objects.list[ da_tracks[i] ].width;
+				}
+
+				// Update orientation and ground level
+				track.geo.orientation = 
+					detected_objects.list[ da_tracks[i] ].orientation;
+				track.sta.z = 
+					detected_objects.list[ da_tracks[i] ].world_pose.point.z;
+
+				/*
+				// Print Update
+				ROS_INFO("Update of T[%d] A[%d] z=[%f,%f] x=[%f,%f,%f,%f,%f],"
+					" P=[%f,%f,%f,%f,%f]", track.id, track.hist.good_age,
+					z[0], z[1],
+					track.sta.x(0), track.sta.x(1), track.sta.x(2), 
+					track.sta.x(3), track.sta.x(4),	
+					track.sta.P(0), track.sta.P(6), track.sta.P(12), 
+					track.sta.P(18), track.sta.P(24)
+				);
+				*/
+			}
+		}
+	});
+}
+
+void Tracker::TrackManagement(const ObjectArray & detected_objects){
+
+	// Delete spuriors tracks, backwards as the last track takes the position
+	// of a deleted one
+	for(int i = tracks_.size() - 1; i >= 0; --i){
+
+		// Deletion condition
+		if(tracks_[i].hist.bad_age >= params_.tra_aging_bad){
+
+			// Print
+			ROS_INFO("Deletion of T [%d]", tracks_[i].id);
+
+			// Free slot of the track
+			tracks_.erase(i);
+		}
+	}
+
+	// Create new ones out of untracked new detected object hypothesis
+	// Initialize tracks
+	for(int i = 0; i < detected_objects.list.size(); ++i){
+
+		// Unassigned object condition
+		if(da_objects[i] == -1){
+
+			// Init new track
+			initTrack(detected_objects.list[i]);
+		}
+	}
+}
+
+void Tracker::initTrack(const Object & obj){
+
+	// Only if object can be a track
+	if(! obj.is_track)
+		return;
+
+	// Create new track
+	Track tr = Track();
+
+	// Add id and increment
+	tr.id = track_id_counter_;
+	track_id_counter_++;
+
+	// Add state information
+	tr.sta.x = Filter::StateVector::Zero(params_.tra_dim_x);
+	tr.sta.x[0] = obj.world_pose.point.x;
+	tr.sta.x[1] = obj.world_pose.point.y;
+	tr.sta.z = obj.world_pose.point.z;
+	tr.sta.P = Filter::StateMatrix::Zero(params_.tra_dim_x, params_.tra_dim_x);
+	tr.sta.P << params_.p_init_x,  0,  0,  0,  0,
+				0,  params_.p_init_y,  0,  0,  0,
+				0,  0,	params_.p_init_v,  0,  0,
+				0,  0,  0,params_.p_init_yaw,  0,
+				0,  0,  0,  0,  params_.p_init_yaw_rate;
+	tr.sta.L = tr.sta.P.llt().matrixL();
+	for(int m = 0; m < NUM_MODELS; ++m){
+		tr.models.x[m] = tr.sta.x;
+		tr.models.P[m] = tr.sta.P;
+	}
+	tr.models.mu[MODEL_CV] = params_.tra_imm_mu_cv;
+	tr.models.mu[MODEL_CTRV] = 1.0 - params_.tra_imm_mu_cv;
+	tr.sta.Xsig_pred = Filter::SigmaMatrix::Zero(params_.tra_dim_x, 
+		filter_.dimSig());
+
+	// Add geometric information
+	tr.geo.width = obj.width;
+	tr.geo.length = obj.length;
+	tr.geo.height = obj.height;
+	tr.geo.orientation = obj.orientation;
+
+	// Add semantic information
+	tr.sem.name = obj.semantic_name;
+	tr.sem.id = obj.semantic_id;
+	tr.sem.confidence = obj.semantic_confidence;
+
+	// Add unique color
+	tr.r = rng_.uniform(0, 255);
+	tr.g = rng_.uniform(0, 255);
+	tr.b = rng_.uniform(0, 255);
+	
+	// Insert into free slot of the track pool, with an empty trajectory
+	SlotHandle handle = tracks_.insert(tr);
+	trajectories_.reset(handle.index);
+}
+
+void Tracker::getTrackList(ObjectArray & track_list) const{
+
+	track_list.list.clear();
+
+	// Loop over all tracks
+	for(int i = 0; i < tracks_.size(); ++i){
+
+		// Grab track
+		const Track & track = tracks_[i];
+
+		// Create new message and fill it
+		Object track_msg;
+		track_msg.id = track.id;
+		track_msg.world_pose.header.frame_id = "world";
+		track_msg.world_pose.point.x = track.sta.x[0];
+		track_msg.world_pose.point.y = track.sta.x[1];
+		track_msg.world_pose.point.z = track.sta.z;
+
+		track_msg.heading = track.sta.x[3];
+		track_msg.velocity = track.sta.x[2];
+		track_msg.width = track.geo.width;
+		track_msg.length = track.geo.length;
+		track_msg.height = track.geo.height;
+		track_msg.orientation = track.geo.orientation;
+		track_msg.semantic_name = track.sem.name;
+		track_msg.semantic_id = track.sem.id;
+		track_msg.semantic_confidence = track.sem.confidence;
+		track_msg.r = track.r;
+		track_msg.g = track.g;
+		track_msg.b = track.b;
+		track_msg.is_track = true;
+
+		// Push back track message
+		track_list.list.push_back(track_msg);
+	}
+}
+
+void Tracker::saveState(std::vector<char> & buffer) const{
+
+	buffer.clear();
+	BinaryWriter writer(buffer);
+
+	// Header
+	writer.put(SNAPSHOT_MAGIC);
+	writer.put(SNAPSHOT_VERSION);
+	writer.put(params_.tra_dim_x);
+	writer.put(last_time_stamp_);
+	writer.put(track_id_counter_);
+	writer.put(uint64_t(rng_.state));
+	writer.put(int(tracks_.size()));
+
+	// Tracks without predicted sigma points, the next prediction creates them
+	const int n = params_.tra_dim_x;
+	for(int i = 0; i < tracks_.size(); ++i){
+
+		const Track & track = tracks_[i];
+		writer.put(track.id);
+		writer.putArray(track.sta.x.data(), n);
+		writer.put(track.sta.z);
+		writer.putArray(track.sta.P.data(), n * n);
+		writer.putArray(track.sta.L.data(), n * n);
+		for(int m = 0; m < NUM_MODELS; ++m){
+			writer.putArray(track.models.x[m].data(), n);
+			writer.putArray(track.models.P[m].data(), n * n);
+			writer.put(track.models.mu[m]);
+		}
+		writer.put(track.geo);
+		writer.put(track.sem.id);
+		writer.putString(track.sem.name);
+		writer.put(track.sem.confidence);
+		writer.put(track.hist);
+		writer.put(track.r);
+		writer.put(track.g);
+		writer.put(track.b);
+
+		// Trajectory from oldest to newest point
+		int slot = tracks_.handle(i).index;
+		writer.put(trajectories_.size(slot));
+		for(int k = 0; k < trajectories_.size(slot); ++k)
+			writer.put(trajectories_.at(slot, k));
+	}
+}
+
+bool Tracker::restoreState(const std::vector<char> & buffer,
+	const double time_stamp, const double max_age){
+
+	BinaryReader reader(buffer);
+
+	// Header
+	int magic, version, dim_x, id_counter, num_tracks;
+	double stamp;
+	uint64_t rng_state;
+	if(!reader.get(magic) || magic != SNAPSHOT_MAGIC ||
+		!reader.get(version) || version != SNAPSHOT_VERSION ||
+		!reader.get(dim_x) || dim_x != params_.tra_dim_x ||
+		!reader.get(stamp) || !reader.get(id_counter) ||
+		!reader.get(rng_state) || !reader.get(num_tracks) || num_tracks < 0){
+		ROS_WARN("Tracking snapshot does not fit the filter");
+		return false;
+	}
+
+	// Only continue from a recent snapshot of the same sequence
+	double age = time_stamp - stamp;
+	if(age < 0.0 || age > max_age){
+		ROS_WARN("Tracking snapshot is [%f] s old, starting without tracks",
+			age);
+		return false;
+	}
+
+	// Read all tracks before replacing the current ones
+	const int n = dim_x;
+	std::vector<Track, aligned_allocator<Track> > restored(num_tracks);
+	std::vector<std::vector<TrajectoryPoint> > paths(num_tracks);
+	for(int i = 0; i < num_tracks; ++i){
+
+		Track & track = restored[i];
+		track.sta.x.resize(n);
+		track.sta.P.resize(n, n);
+		track.sta.L.resize(n, n);
+		track.sta.Xsig_pred = Filter::SigmaMatrix::Zero(n, filter_.dimSig());
+		bool ok = reader.get(track.id) &&
+			reader.getArray(track.sta.x.data(), n) &&
+			reader.get(track.sta.z) &&
+			reader.getArray(track.sta.P.data(), n * n) &&
+			reader.getArray(track.sta.L.data(), n * n);
+		for(int m = 0; ok && m < NUM_MODELS; ++m){
+			track.models.x[m].resize(n);
+			track.models.P[m].resize(n, n);
+			ok = reader.getArray(track.models.x[m].data(), n) &&
+				reader.getArray(track.models.P[m].data(), n * n) &&
+				reader.get(track.models.mu[m]);
+		}
+		ok = ok && reader.get(track.geo) && reader.get(track.sem.id) &&
+			reader.getString(track.sem.name) &&
+			reader.get(track.sem.confidence) && reader.get(track.hist) &&
+			reader.get(track.r) && reader.get(track.g) && reader.get(track.b);
+		int num_points;
+		ok = ok && reader.get(num_points) && num_points >= 0 &&
+			num_points <= trajectories_.length();
+		if(ok){
+			paths[i].resize(num_points);
+			for(int k = 0; ok && k < num_points; ++k)
+				ok = reader.get(paths[i][k]);
+		}
+		if(!ok){
+			ROS_WARN("Tracking snapshot is truncated");
+			return false;
+		}
+	}
+	if(!reader.done()){
+		ROS_WARN("Tracking snapshot has trailing data");
+		return false;
+	}
+
+	// Continue as if the frames in between were missed
+	tracks_.clear();
+	for(int i = 0; i < restored.size(); ++i){
+		int slot = tracks_.insert(restored[i]).index;
+		trajectories_.reset(slot);
+		for(int k = 0; k < paths[i].size(); ++k)
+			trajectories_.push(slot, paths[i][k]);
+	}
+	track_id_counter_ = id_counter;
+	rng_.state = rng_state;
+	last_time_stamp_ = stamp;
+	is_initialized_ = true;
+
+	// Frames before the snapshot are not recorded
+	history_size_ = 0;
+	evicted_time_stamp_ = stamp;
+	return true;
+}
+
+bool Tracker::isInitialized() const{
+
+	return is_initialized_;
+}
+
+double Tracker::getTimeStamp() const{
+
+	return last_time_stamp_;
+}
+
+const ReplayStatistics & Tracker::getReplayStatistics() const{
+
+	return replay_stats_;
+}
+
+void Tracker::getTrajectoryList(TrajectoryArray & trajectory_list) const{
+
+	trajectory_list.list.resize(tracks_.size());
+	for(int i = 0; i < tracks_.size(); ++i){
+
+		// Copy the ring of the track slot from oldest to newest point
+		Trajectory & trajectory = trajectory_list.list[i];
+		int slot = tracks_.handle(i).index;
+		int n = trajectories_.size(slot);
+		trajectory.id = tracks_[i].id;
+		trajectory.stamps.resize(n);
+		trajectory.points.resize(n);
+		trajectory.velocities.resize(n);
+		trajectory.headings.resize(n);
+		for(int k = 0; k < n; ++k){
+			const TrajectoryPoint & point = trajectories_.at(slot, k);
+			trajectory.stamps[k] = ros::Time(point.stamp);
+			trajectory.points[k].x = point.x;
+			trajectory.points[k].y = point.y;
+			trajectory.points[k].z = tracks_[i].sta.z;
+			trajectory.velocities[k] = point.v;
+			trajectory.headings[k] = point.yaw;
+		}
+	}
+}
+
+void Tracker::predictTrackList(const double time_stamp,
+	ObjectArray & track_list){
+
+	getTrackList(track_list);
+	track_list.header.stamp = ros::Time(time_stamp);
+
+	// Predict the sigma points of all tracks in one kernel, interacting
+	// models are predicted from their combined state with the CTRV model
+	double delta_t = time_stamp - last_time_stamp_;
+	query_batch_.clear();
+	for(int i = 0; i < tracks_.size(); ++i)
+		query_batch_.add(tracks_[i].sta.x, tracks_[i].sta.P);
+	query_batch_.predict(delta_t);
+	query_batch_.computeMean();
+
+	// Overwrite the kinematic state of the track messages
+	Filter::StateVector x;
+	for(int i = 0; i < tracks_.size(); ++i){
+		query_batch_.getMean(i, x);
+		Object & track_msg = track_list.list[i];
+		track_msg.world_pose.header.stamp = track_list.header.stamp;
+		track_msg.world_pose.point.x = x[0];
+		track_msg.world_pose.point.y = x[1];
+		track_msg.velocity = x[2];
+		track_msg.heading = Filter::normalizeAngle(x[3]);
+	}
+}
+
+void Tracker::getForecastList(ForecastArray & forecast_list){
+
+	std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+
+	// Allocate all horizons of all tracks
+	int steps = std::max(0, params_.tra_forecast_steps);
+	double step = params_.tra_forecast_step;
+	forecast_list.list.resize(tracks_.size());
+	for(int i = 0; i < tracks_.size(); ++i){
+		Forecast & forecast = forecast_list.list[i];
+		forecast.id = tracks_[i].id;
+		forecast.stamps.resize(steps);
+		forecast.points.resize(steps);
+		forecast.velocities.resize(steps);
+		forecast.headings.resize(steps);
+		forecast.major.resize(steps);
+		forecast.minor.resize(steps);
+		forecast.orientations.resize(steps);
+	}
+
+	// Generate the sigma points of all tracks once and step them through all
+	// horizons in one kernel. The noise samples are kept, so each sigma point
+	// moves with constant acceleration and yaw acceleration over the whole
+	// forecast. Interacting models start from their combined state.
+	query_batch_.clear();
+	for(int i = 0; i < tracks_.size(); ++i)
+		query_batch_.add(tracks_[i].sta.x, tracks_[i].sta.P);
+
+	Filter::StateVector x;
+	Matrix2d P;
+	for(int k = 0; k < steps; ++k){
+
+		if(k > 0)
+			query_batch_.advance();
+		query_batch_.predict(step);
+		query_batch_.computeMean();
+
+		// Mean and principal axes of the position covariance
+		ros::Time stamp(last_time_stamp_ + (k + 1) * step);
+		for(int i = 0; i < tracks_.size(); ++i){
+			query_batch_.getMean(i, x);
+			query_batch_.getPositionCovariance(i, P);
+			Forecast & forecast = forecast_list.list[i];
+			forecast.stamps[k] = stamp;
+			forecast.points[k].x = x(0);
+			forecast.points[k].y = x(1);
+			forecast.points[k].z = tracks_[i].sta.z;
+			forecast.velocities[k] = x(2);
+			forecast.headings[k] = Filter::normalizeAngle(x(3));
+			double mean = 0.5 * (P(0,0) + P(1,1));
+			double radius = std::sqrt(0.25 * (P(0,0) - P(1,1)) *
+				(P(0,0) - P(1,1)) + P(0,1) * P(0,1));
+			forecast.major[k] = std::sqrt(mean + radius);
+			forecast.minor[k] = std::sqrt(std::max(0.0, mean - radius));
+			forecast.orientations[k] = 0.5 * std::atan2(2.0 * P(0,1),
+				P(0,0) - P(1,1));
+		}
+	}
+
+	stage_times_.forecast += std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+const StageTimes & Tracker::getStageTimes() const{
+
+	return stage_times_;
+}
+
+void Tracker::resetStageTimes(){
+
+	stage_times_ = StageTimes();
+}
+
+const TrajectoryStore & Tracker::getTrajectories() const{
+
+	return trajectories_;
+}
+
+const Parameter & Tracker::getParameter() const{
+
+	return params_;
+}
+
+const TrackPool & Tracker::getTracks() const{
+
+	return tracks_;
+}
+
+void Tracker::printTrack(const Track & tr) const{
+
+	ROS_INFO("Track [%d] x=[%f,%f,%f,%f,%f], z=[%f]"
+		" P=[%f,%f,%f,%f,%f] is [%s, %f] A[%d] [w,l,h,o] [%f,%f,%f,%f]", 
+		tr.id,
+		tr.sta.x(0), tr.sta.x(1), tr.sta.x(2), tr.sta.x(3), tr.sta.x(4),
+		tr.sta.z,
+		tr.sta.P(0), tr.sta.P(6), tr.sta.P(12), tr.sta.P(18), tr.sta.P(24),
+		tr.sem.name.c_str(), tr.sem.confidence,
+		tr.hist.good_age,
+		tr.geo.width, tr.geo.length,
+		tr.geo.height, tr.geo.orientation
+	);
+}
+
+void Tracker::printTracks() const{
+
+	for(int i = 0; i < tracks_.size(); ++i){
+		printTrack(tracks_[i]);
+	}
+}
+
+} // namespace tracking
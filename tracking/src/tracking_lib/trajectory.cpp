@@ -0,0 +1,73 @@
+#include <tracking_lib/trajectory.h>
+
+namespace tracking{
+
+/******************************************************************************/
+
+TrajectoryStore::TrajectoryStore():
+	length_(0)
+	{
+}
+
+TrajectoryStore::~TrajectoryStore(){
+
+}
+
+void TrajectoryStore::init(const int length){
+
+	length_ = length > 0 ? length : 0;
+	points_.clear();
+	begin_.clear();
+	size_.clear();
+}
+
+void TrajectoryStore::reserve(const int num_slots){
+
+	if(num_slots <= begin_.size())
+		return;
+
+	points_.resize(num_slots * length_);
+	begin_.resize(num_slots, 0);
+	size_.resize(num_slots, 0);
+}
+
+void TrajectoryStore::reset(const int slot){
+
+	reserve(slot + 1);
+	begin_[slot] = 0;
+	size_[slot] = 0;
+}
+
+void TrajectoryStore::push(const int slot, const TrajectoryPoint & point){
+
+	if(length_ == 0)
+		return;
+
+	reserve(slot + 1);
+	if(size_[slot] < length_){
+		points_[slot * length_ + (begin_[slot] + size_[slot]) % length_] = point;
+		size_[slot]++;
+	}
+	else{
+		points_[slot * length_ + begin_[slot]] = point;
+		begin_[slot] = (begin_[slot] + 1) % length_;
+	}
+}
+
+int TrajectoryStore::size(const int slot) const{
+
+	return slot < size_.size() ? size_[slot] : 0;
+}
+
+const TrajectoryPoint & TrajectoryStore::at(const int slot,
+	const int k) const{
+
+	return points_[slot * length_ + (begin_[slot] + k) % length_];
+}
+
+int TrajectoryStore::length() const{
+
+	return length_;
+}
+
+} // namespace tracking
@@ -0,0 +1,293 @@
+/******************************************************************************
+ *
+ * Offline tracking of recorded detections in KITTI result format, with
+ * metrics against the KITTI labels of each sequence if a label directory is
+ * given.
+ * Usage: rosrun tracking tracking_offline --config parameters.yaml
+ *        [--output ~/kitti_results] [--jobs N] [--labels label_02]
+ *        [--min_iou 0.5] 0000.bag 0001.bag ...
+ *
+ */
+
+#include <tracking_lib/replay.h>
+#include <evaluation_lib/clear_mot.h>
+#include <ros/console.h>
+#include <yaml-cpp/yaml.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace tracking;
+using evaluation::ClearMot;
+using evaluation::KittiLabels;
+using evaluation::MotMetrics;
+
+// Parameter source on a yaml file with the ros::NodeHandle::param interface
+class YamlSource{
+
+public:
+
+	YamlSource(const YAML::Node & root): root_(root) {}
+
+	template<typename T>
+	bool param(const std::string & name, T & value, const T & default_value){
+
+		// Walk the keys separated by slashes
+		std::vector<YAML::Node> path(1, root_);
+		std::stringstream stream(name);
+		std::string key;
+		while(std::getline(stream, key, '/')){
+			const YAML::Node & parent = path.back();
+			if(!parent.IsMap() || !parent[key]){
+				value = default_value;
+				return false;
+			}
+			path.push_back(parent[key]);
+		}
+		value = path.back().as<T>();
+		return true;
+	}
+
+private:
+
+	YAML::Node root_;
+};
+
+static std::string getArg(int argc, char ** argv, const std::string & name,
+	const std::string & default_value){
+
+	for(int i = 1; i < argc - 1; ++i){
+		if(name == argv[i])
+			return argv[i + 1];
+	}
+	return default_value;
+}
+
+// Bag name without directory and extension
+static std::string getSequenceName(const std::string & filename){
+
+	std::string name = filename.substr(filename.find_last_of('/') + 1);
+	return name.substr(0, name.find_last_of('.'));
+}
+
+// Size of a file in bytes, 0 if it does not exist
+static long getFileSize(const std::string & filename){
+
+	struct stat info;
+	return (stat(filename.c_str(), &info) == 0) ? long(info.st_size) : 0;
+}
+
+// Outcome of one sequence
+struct SequenceResult{
+
+	bool done;
+	bool evaluated;
+	int frames;
+	int tracks;
+	double seconds;
+	MotMetrics car;
+	MotMetrics pedestrian;
+};
+
+// Metrics of one class over the records of all frames of a sequence
+static MotMetrics evaluate(const KittiLabels & labels,
+	const std::string & class_name, const double min_iou, const int frames,
+	const std::vector<KittiRecord> & records){
+
+	ClearMot metrics;
+	metrics.init(&labels, class_name, min_iou);
+	int begin = 0;
+	for(int frame = 0; frame < frames; ++frame){
+		int end = begin;
+		while(end < records.size() && records[end].frame == frame)
+			end++;
+		metrics.addFrame(frame, records.data() + begin, end - begin);
+		begin = end;
+	}
+	return metrics.getMetrics();
+}
+
+int main(int argc, char **argv){
+
+	// Read configuration
+	std::string config = getArg(argc, argv, "--config", "");
+	std::string output = getArg(argc, argv, "--output", ".");
+	std::string label_dir = getArg(argc, argv, "--labels", "");
+	double min_iou = std::atof(getArg(argc, argv, "--min_iou",
+		"0.5").c_str());
+	int jobs = std::atoi(getArg(argc, argv, "--jobs",
+		"0").c_str());
+
+	std::vector<std::string> bags;
+	for(int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if(arg == "--config" || arg == "--output" || arg == "--jobs" ||
+			arg == "--labels" || arg == "--min_iou")
+			++i;
+		else
+			bags.push_back(arg);
+	}
+	if(config.empty() || bags.empty()){
+		std::printf("Usage: tracking_offline --config parameters.yaml"
+			" [--output dir] [--jobs N] [--labels dir] [--min_iou 0.5]"
+			" bag...\n");
+		return 1;
+	}
+
+	// One worker per sequence by default
+	if(jobs <= 0)
+		jobs = bags.size();
+
+	// Per track warnings would dominate the run time
+	ros::Time::init();
+	if(ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME,
+		ros::console::levels::Error))
+		ros::console::notifyLoggerLevelsChanged();
+
+	// Same parameters as the tracking node
+	Parameter params;
+	try{
+		YamlSource source(YAML::LoadFile(config));
+		loadParameter(source, params);
+	}
+	catch(YAML::Exception & ex){
+		std::printf("Failed to read %s: %s\n", config.c_str(), ex.what());
+		return 1;
+	}
+
+	// Largest bags first, so with fewer workers than sequences the longest
+	// ones do not start last
+	std::vector<int> order(bags.size());
+	std::vector<long> bag_size(bags.size());
+	for(int i = 0; i < bags.size(); ++i){
+		order[i] = i;
+		bag_size[i] = getFileSize(bags[i]);
+	}
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+		return bag_size[a] > bag_size[b]; });
+
+	// Sequences are independent, each job takes the next one with its own
+	// tracker and metrics
+	std::vector<SequenceResult> sequences(bags.size(), SequenceResult());
+	std::atomic<int> next(0);
+	std::mutex print_mutex;
+	std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for(int w = 0; w < std::min<int>(jobs, bags.size()); ++w){
+		workers.push_back(std::thread([&](){
+
+			for(int k = next++; k < bags.size(); k = next++){
+
+				int i = order[k];
+				SequenceResult & sequence = sequences[i];
+				std::chrono::steady_clock::time_point t0 =
+					std::chrono::steady_clock::now();
+				SequenceReplay replay;
+				if(!replay.open(bags[i]))
+					continue;
+
+				std::string name = getSequenceName(bags[i]);
+				std::string filename = output + "/" + name + ".txt";
+				std::ofstream results(filename.c_str(),
+					std::ofstream::out | std::ofstream::trunc);
+				if(!results.is_open()){
+					std::lock_guard<std::mutex> lock(print_mutex);
+					std::printf("Failed to write %s\n", filename.c_str());
+					continue;
+				}
+				std::vector<KittiRecord> records;
+				sequence.frames = replay.size();
+				sequence.tracks = replay.run(params, results,
+					label_dir.empty() ? NULL : &records);
+
+				// Metrics against the labels of the sequence
+				if(!label_dir.empty()){
+					KittiLabels labels;
+					sequence.evaluated = labels.load(label_dir + "/" + name +
+						".txt");
+					if(sequence.evaluated){
+						sequence.car = evaluate(labels, "Car", min_iou,
+							sequence.frames, records);
+						sequence.pedestrian = evaluate(labels, "Pedestrian",
+							min_iou, sequence.frames, records);
+					}
+				}
+				sequence.seconds = std::chrono::duration<double>(
+					std::chrono::steady_clock::now() - t0).count();
+				sequence.done = true;
+
+				std::lock_guard<std::mutex> lock(print_mutex);
+				std::printf("%s: %d frames, %d tracks in %.3f s -> %s\n",
+					bags[i].c_str(), sequence.frames, sequence.tracks,
+					sequence.seconds, filename.c_str());
+				if(!label_dir.empty() && !sequence.evaluated)
+					std::printf("%s: no labels in %s\n", bags[i].c_str(),
+						label_dir.c_str());
+			}
+		}));
+	}
+	for(int w = 0; w < workers.size(); ++w)
+		workers[w].join();
+	double wall_time = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+
+	// Report of all sequences in the given order
+	MotMetrics car = MotMetrics();
+	MotMetrics pedestrian = MotMetrics();
+	double sequence_time = 0.0;
+	double longest_time = 0.0;
+	int evaluated = 0;
+	int failed = 0;
+	std::printf("\n%-12s %7s %8s %9s %9s %9s %9s %9s\n", "Sequence", "Frames",
+		"Tracks", "Time[s]", "Car MOTA", "Car IDF1", "Ped MOTA", "Ped IDF1");
+	for(int i = 0; i < bags.size(); ++i){
+
+		const SequenceResult & sequence = sequences[i];
+		if(!sequence.done){
+			std::printf("%-12s failed\n", getSequenceName(bags[i]).c_str());
+			failed++;
+			continue;
+		}
+		sequence_time += sequence.seconds;
+		longest_time = std::max(longest_time, sequence.seconds);
+		std::printf("%-12s %7d %8d %9.3f", getSequenceName(bags[i]).c_str(),
+			sequence.frames, sequence.tracks, sequence.seconds);
+		if(sequence.evaluated){
+			std::printf(" %9.3f %9.3f %9.3f %9.3f", sequence.car.mota,
+				sequence.car.idf1, sequence.pedestrian.mota,
+				sequence.pedestrian.idf1);
+			addMetrics(car, sequence.car);
+			addMetrics(pedestrian, sequence.pedestrian);
+			evaluated++;
+		}
+		std::printf("\n");
+	}
+
+	// Metrics of the counts of all sequences
+	if(evaluated > 0){
+		std::printf("\n%d evaluated sequences\n", evaluated);
+		evaluation::printMetrics(std::cout, "Car", car);
+		std::cout << "\n";
+		evaluation::printMetrics(std::cout, "Pedestrian", pedestrian);
+		std::cout << std::endl;
+	}
+
+	std::printf("\n%d sequences in %.3f s on %d workers, %.3f s in total,"
+		" longest %.3f s\n", int(bags.size()), wall_time,
+		std::min<int>(jobs, bags.size()), sequence_time, longest_time);
+
+	// Unreadable bags or unwritable results fail the run
+	if(failed > 0){
+		std::printf("%d of %d sequences failed\n", failed, int(bags.size()));
+		return 1;
+	}
+	return 0;
+}